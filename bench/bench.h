@@ -0,0 +1,50 @@
+/**
+ * @file bench.h
+ * @brief Timing helpers shared by the host benchmarks in this directory.
+ * @date 2026-10-17
+ *
+ * The benchmarks build on their own with any C++20 compiler, outside the
+ * vcxproj (see BUILD.md). They take the best of several runs, which is the
+ * least disturbed by the rest of the machine.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Keeps a result alive so the compiler can't drop the work that made it
+inline volatile uint64_t g_benchSink = 0;
+
+inline void Consume(uint64_t value)
+{
+	g_benchSink = g_benchSink + value;
+}
+
+// Best time of runs calls to fn, in nanoseconds per op
+template <typename Fn>
+double MeasureNsPerOp(size_t ops, Fn&& fn, int runs = 15)
+{
+	double best = 1e300;
+	for (int run = 0; run < runs; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	return best / static_cast<double>(ops);
+}
+
+inline void PrintHeader(const char* title, const char* baseline, const char* candidate)
+{
+	printf("%s\n", title);
+	printf("  %-24s %12s %12s %8s\n", "", baseline, candidate, "speedup");
+}
+
+inline void PrintRow(const char* name, double baselineNs, double candidateNs)
+{
+	printf("  %-24s %9.1f ns %9.1f ns %7.2fx\n", name, baselineNs, candidateNs, baselineNs / candidateNs);
+}
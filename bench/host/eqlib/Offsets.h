@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+namespace eqlib
+{
+	inline uintptr_t FixEQGameOffset(uintptr_t offset) { return offset; }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Never called on the host; the values only have to be distinct
+#define MapViewMap__GetWorldCoordinates_x 0x1
+#define MapViewMap__vftable_x 0x2
+#define PcClient__GetConLevel_x 0x3
+#define PlayerManagerClient__GetSpawnByID_x 0x4
+#define __HWnd_x 0x5
@@ -0,0 +1,95 @@
+/**
+ * @file windows.h
+ * @brief Just enough of the Win32 API to build the map's search code on the host.
+ * @date 2026-10-17
+ *
+ * Only for the benchmarks: nothing here talks to a real window or process.
+ * VirtualQuery reports every address unreadable, which GameList takes as a
+ * bad pointer, so host walks never leave memory the benchmark owns.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <strings.h>
+
+typedef unsigned long DWORD;
+typedef int BOOL;
+typedef long HRESULT;
+typedef void* HINSTANCE;
+typedef void* HWND;
+typedef void* LPVOID;
+typedef void* LPUNKNOWN;
+typedef const struct _GUID& REFIID;
+typedef const struct _GUID& REFCLSID;
+
+#define WINAPI
+#define __fastcall
+
+// SEH: g++ -fno-exceptions already turns __try into if (true)
+#define __except(filter) else
+
+#define VK_SHIFT 0x10
+#define VK_CONTROL 0x11
+#define VK_MENU 0x12
+
+#define MEM_COMMIT 0x1000
+#define PAGE_NOACCESS 0x01
+#define PAGE_READONLY 0x02
+#define PAGE_READWRITE 0x04
+#define PAGE_WRITECOPY 0x08
+#define PAGE_EXECUTE_READ 0x20
+#define PAGE_EXECUTE_READWRITE 0x40
+#define PAGE_EXECUTE_WRITECOPY 0x80
+#define PAGE_GUARD 0x100
+
+struct MEMORY_BASIC_INFORMATION
+{
+	void*  BaseAddress;
+	void*  AllocationBase;
+	DWORD  AllocationProtect;
+	size_t RegionSize;
+	DWORD  State;
+	DWORD  Protect;
+	DWORD  Type;
+};
+
+inline size_t VirtualQuery(const void*, MEMORY_BASIC_INFORMATION*, size_t) { return 0; }
+inline short GetKeyState(int) { return 0; }
+
+#define _stricmp strcasecmp
+
+template <size_t N>
+int strcpy_s(char (&dest)[N], const char* src)
+{
+	snprintf(dest, N, "%s", src);
+	return 0;
+}
+
+inline int strcpy_s(char* dest, size_t size, const char* src)
+{
+	snprintf(dest, size, "%s", src);
+	return 0;
+}
+
+template <size_t N>
+int strcat_s(char (&dest)[N], const char* src)
+{
+	size_t length = strlen(dest);
+	snprintf(dest + length, N - length, "%s", src);
+	return 0;
+}
+
+template <size_t N, typename... Args>
+int sprintf_s(char (&dest)[N], const char* format, Args... args)
+{
+	return snprintf(dest, N, format, args...);
+}
+
+template <typename... Args>
+int sprintf_s(char* dest, size_t size, const char* format, Args... args)
+{
+	return snprintf(dest, size, format, args...);
+}
@@ -0,0 +1,244 @@
+/**
+ * @file marker_bench.cpp
+ * @brief Batched SoA marker transforms (SSE2 and scalar) against BuildMarker.
+ * @date 2026-10-17
+ *
+ * Markers used to be queued into per-shape structure-of-arrays buckets
+ * during MapUpdate and transformed four at a time with SSE2 at the end of
+ * the frame. That batch is reproduced here, with both its SSE2 and scalar
+ * kernels, and timed against building each marker straight into its lines
+ * with the real BuildMarker. 5000 markers of mixed shapes and headings,
+ * queue through scatter, per marker. Needs an x86 host for SSE2.
+ *
+ *   g++ -std=c++20 -O2 -fno-exceptions -Ibench/host -I. -Imods/map \
+ *       bench/marker_bench.cpp mods/map/map_geometry.cpp -o marker_bench
+ */
+
+#include "../pch.h"      // the DLL's, over the stand-ins in bench/host
+#include "bench.h"
+#include "map_geometry.h"
+
+#include <emmintrin.h>
+
+#include <random>
+#include <vector>
+
+static constexpr size_t MarkerCount = 5000;
+
+static const MarkerType s_types[] = {
+	MarkerType::Triangle, MarkerType::Square, MarkerType::Diamond, MarkerType::Ring,
+};
+
+// As GetMarkerScale in map_geometry.cpp
+static float GetScale(MarkerType type, uint32_t sideLength)
+{
+	switch (type)
+	{
+	case MarkerType::Triangle: return (sideLength * 1.5f) * sqrtf(3) / 3;
+	case MarkerType::Square: return static_cast<float>(sideLength / 2);
+	case MarkerType::Diamond: return sideLength * .71f;
+	case MarkerType::Ring: return static_cast<float>(sideLength);
+	default: return 0.0f;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// The SoA batch, one bucket per shape
+// ---------------------------------------------------------------------------
+
+class Batch
+{
+public:
+	void Add(const MarkerGeometry& geometry, MapViewLine* const* lines)
+	{
+		const MarkerTemplate& shape = GetMarkerTemplate(geometry.Type);
+		SinCos rotation = shape.Rotates ? GetHeadingSinCos(geometry.Heading) : SinCos{ 0.0f, 1.0f };
+
+		Bucket& bucket = m_buckets[static_cast<int>(geometry.Type)];
+		bucket.X.push_back(geometry.X);
+		bucket.Y.push_back(geometry.Y);
+		bucket.Z.push_back(geometry.Z);
+		bucket.Scale.push_back(GetScale(geometry.Type, geometry.SideLength));
+		bucket.Sin.push_back(rotation.Sin);
+		bucket.Cos.push_back(rotation.Cos);
+		bucket.Color.push_back(geometry.ColorARGB);
+		bucket.Lines.push_back(lines);
+	}
+
+	template <bool UseSSE2>
+	void Flush()
+	{
+		for (MarkerType type : s_types)
+		{
+			Bucket& bucket = m_buckets[static_cast<int>(type)];
+			const MarkerTemplate& shape = GetMarkerTemplate(type);
+			Transform<UseSSE2>(shape, bucket);
+			Scatter(shape, bucket);
+			bucket.Clear();
+		}
+	}
+
+private:
+	struct Bucket
+	{
+		std::vector<float> X, Y, Z, Scale, Sin, Cos;
+		std::vector<uint32_t> Color;
+		std::vector<MapViewLine* const*> Lines;
+		std::vector<float> OutX, OutY;     // [vertex * padded count + marker]
+
+		void Clear()
+		{
+			X.clear(); Y.clear(); Z.clear(); Scale.clear();
+			Sin.clear(); Cos.clear(); Color.clear(); Lines.clear();
+		}
+	};
+
+	template <bool UseSSE2>
+	static void Transform(const MarkerTemplate& shape, Bucket& bucket)
+	{
+		size_t padded = (bucket.Lines.size() + 3) & ~size_t(3);
+		bucket.X.resize(padded, 0.0f);
+		bucket.Y.resize(padded, 0.0f);
+		bucket.Scale.resize(padded, 0.0f);
+		bucket.Sin.resize(padded, 0.0f);
+		bucket.Cos.resize(padded, 0.0f);
+		bucket.OutX.resize(padded * shape.VertexCount);
+		bucket.OutY.resize(padded * shape.VertexCount);
+
+		for (int v = 0; v < shape.VertexCount; v++)
+		{
+			float* outX = &bucket.OutX[v * padded];
+			float* outY = &bucket.OutY[v * padded];
+
+			if constexpr (UseSSE2)
+			{
+				const __m128 u = _mm_set1_ps(shape.U[v]);
+				const __m128 w = _mm_set1_ps(shape.V[v]);
+
+				for (size_t i = 0; i < padded; i += 4)
+				{
+					__m128 sn = _mm_loadu_ps(&bucket.Sin[i]);
+					__m128 cs = _mm_loadu_ps(&bucket.Cos[i]);
+					__m128 scale = _mm_loadu_ps(&bucket.Scale[i]);
+					__m128 rx = _mm_add_ps(_mm_mul_ps(u, cs), _mm_mul_ps(w, sn));
+					__m128 ry = _mm_sub_ps(_mm_mul_ps(w, cs), _mm_mul_ps(u, sn));
+
+					_mm_storeu_ps(outX + i, _mm_add_ps(_mm_loadu_ps(&bucket.X[i]), _mm_mul_ps(scale, rx)));
+					_mm_storeu_ps(outY + i, _mm_add_ps(_mm_loadu_ps(&bucket.Y[i]), _mm_mul_ps(scale, ry)));
+				}
+			}
+			else
+			{
+				const float u = shape.U[v];
+				const float w = shape.V[v];
+
+				for (size_t i = 0; i < padded; i++)
+				{
+					outX[i] = bucket.X[i] + bucket.Scale[i] * (u * bucket.Cos[i] + w * bucket.Sin[i]);
+					outY[i] = bucket.Y[i] + bucket.Scale[i] * (w * bucket.Cos[i] - u * bucket.Sin[i]);
+				}
+			}
+		}
+	}
+
+	static void Scatter(const MarkerTemplate& shape, Bucket& bucket)
+	{
+		size_t count = bucket.Lines.size();
+		size_t padded = (count + 3) & ~size_t(3);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			MapViewLine* const* lines = bucket.Lines[i];
+			for (int v = 0; v < shape.VertexCount; v++)
+			{
+				int next = (v + 1) % shape.VertexCount;
+				MapViewLine* line = lines[v];
+				line->Start.X = bucket.OutX[v * padded + i];
+				line->Start.Y = bucket.OutY[v * padded + i];
+				line->End.X = bucket.OutX[next * padded + i];
+				line->End.Y = bucket.OutY[next * padded + i];
+				line->Start.Z = bucket.Z[i];
+				line->End.Z = bucket.Z[i];
+				if (line->Color.ARGB != bucket.Color[i])
+					line->Color.ARGB = bucket.Color[i];
+			}
+		}
+	}
+
+	Bucket m_buckets[static_cast<int>(MarkerType::Ring) + 1];
+};
+
+// ---------------------------------------------------------------------------
+
+static bool SameLines(const std::vector<MapViewLine>& a, const std::vector<MapViewLine>& b)
+{
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (fabsf(a[i].Start.X - b[i].Start.X) > 0.01f || fabsf(a[i].Start.Y - b[i].Start.Y) > 0.01f
+			|| fabsf(a[i].End.X - b[i].End.X) > 0.01f || fabsf(a[i].End.Y - b[i].End.Y) > 0.01f)
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	std::mt19937 random(12345);
+
+	std::vector<MarkerGeometry> markers(MarkerCount);
+	size_t lineCount = 0;
+	for (MarkerGeometry& geometry : markers)
+	{
+		geometry.Type = s_types[random() % std::size(s_types)];
+		geometry.X = static_cast<float>(random() % 4000) - 2000.0f;
+		geometry.Y = static_cast<float>(random() % 4000) - 2000.0f;
+		geometry.Z = static_cast<float>(random() % 200);
+		geometry.SideLength = 5 + random() % 10;
+		geometry.Heading = static_cast<float>(random() % 512);
+		geometry.ColorARGB = 0xff00ff00;
+		lineCount += GetMarkerLineCount(geometry.Type);
+	}
+
+	// Each marker owns a run of lines, as MapObject::m_markerLines does
+	std::vector<MapViewLine> lines(lineCount);
+	std::vector<std::vector<MapViewLine*>> owned(MarkerCount);
+	for (size_t i = 0, next = 0; i < MarkerCount; i++)
+	{
+		for (int l = 0; l < GetMarkerLineCount(markers[i].Type); l++)
+			owned[i].push_back(&lines[next++]);
+	}
+
+	Batch batch;
+	auto buildAll = [&] {
+		for (size_t i = 0; i < MarkerCount; i++)
+			BuildMarker(markers[i], owned[i].data());
+		Consume(static_cast<uint64_t>(lines.back().End.X));
+	};
+	auto batchAll = [&]<bool UseSSE2>() {
+		for (size_t i = 0; i < MarkerCount; i++)
+			batch.Add(markers[i], owned[i].data());
+		batch.Flush<UseSSE2>();
+		Consume(static_cast<uint64_t>(lines.back().End.X));
+	};
+
+	// Same lines first
+	buildAll();
+	std::vector<MapViewLine> expected = lines;
+	batchAll.operator()<true>();
+	bool sse2Same = SameLines(expected, lines);
+	batchAll.operator()<false>();
+	if (!sse2Same || !SameLines(expected, lines))
+	{
+		printf("mismatch\n");
+		return 1;
+	}
+
+	double scalar = MeasureNsPerOp(MarkerCount, [&] { batchAll.operator()<false>(); });
+	double sse2 = MeasureNsPerOp(MarkerCount, [&] { batchAll.operator()<true>(); });
+	double immediate = MeasureNsPerOp(MarkerCount, buildAll);
+
+	PrintHeader("5000 markers (per marker)", "batch", "BuildMarker");
+	PrintRow("SoA batch, scalar", scalar, immediate);
+	PrintRow("SoA batch, SSE2", sse2, immediate);
+	return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file name_matcher_bench.cpp
+ * @brief NameMatcher against a find per pattern, 10000 names x 200 patterns.
+ * @date 2026-10-17
+ *
+ * The per-pattern loop is what every rule or highlight set with a name did
+ * on its own: lower the name, then look for its pattern. The matcher finds
+ * all 200 in one pass. A zone has far fewer distinct names than spawns, so
+ * the last case looks each name's scan up by its index, as the rules and
+ * searches now do per NameID.
+ *
+ *   g++ -std=c++20 -O2 -Ibench -Imods/map bench/name_matcher_bench.cpp mods/map/name_matcher.cpp -o name_matcher_bench
+ */
+
+#include "bench.h"
+#include "name_matcher.h"
+
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+static constexpr size_t SpawnCount = 10000;
+static constexpr size_t DistinctNames = 1500;
+static constexpr size_t PatternCount = 200;
+
+static const char* s_syllables[] = {
+	"an", "gor", "el", "rat", "nol", "ki", "dra", "sha", "mor", "ul", "ven", "tha",
+	"bri", "ok", "zan", "pu", "lo", "grim", "ash", "ter", "qua", "fe", "dun", "ix",
+};
+
+static std::string MakeWord(std::mt19937& random)
+{
+	std::string word;
+	int syllables = 2 + static_cast<int>(random() % 3);
+	for (int i = 0; i < syllables; i++)
+		word += s_syllables[random() % std::size(s_syllables)];
+	return word;
+}
+
+// Spawn names the way the client has them: "a_gnoll_pup03", "Lord_Bob00"
+static std::string MakeName(std::mt19937& random)
+{
+	std::string name;
+	switch (random() % 3)
+	{
+	case 0: name = "a_"; break;
+	case 1: name = "an_"; break;
+	default: break;
+	}
+
+	std::string first = MakeWord(random);
+	if (name.empty())
+		first[0] = static_cast<char>(toupper(static_cast<unsigned char>(first[0])));
+	name += first + "_" + MakeWord(random);
+	name += static_cast<char>('0' + random() % 10);
+	name += static_cast<char>('0' + random() % 10);
+	return name;
+}
+
+struct PatternSpec
+{
+	std::string Text;
+	bool        Exact;
+};
+
+static std::string Lowered(const std::string& text)
+{
+	std::string lowered = text;
+	for (char& c : lowered)
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	return lowered;
+}
+
+// One pattern at a time, as each search did for itself
+static NameMatcher::Mask ScanEach(const std::vector<PatternSpec>& patterns, const std::string& name)
+{
+	NameMatcher::Mask found;
+	std::string lowered = Lowered(name);
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		bool matched = patterns[i].Exact ? lowered == patterns[i].Text
+			: lowered.find(patterns[i].Text) != std::string::npos;
+		found[i] = matched;
+	}
+	return found;
+}
+
+int main()
+{
+	std::mt19937 random(12345);
+
+	std::vector<std::string> names;
+	for (size_t i = 0; i < DistinctNames; i++)
+		names.push_back(MakeName(random));
+
+	// Spawns share names (a zone of "a_rat" and friends)
+	std::vector<uint32_t> spawnNames;
+	for (size_t i = 0; i < SpawnCount; i++)
+		spawnNames.push_back(static_cast<uint32_t>(random() % DistinctNames));
+
+	// Mostly fragments of real names, some whole names, some that never hit
+	std::vector<PatternSpec> patterns;
+	for (size_t i = 0; i < PatternCount; i++)
+	{
+		const std::string& source = names[random() % DistinctNames];
+		switch (i % 10)
+		{
+		case 0:
+			patterns.push_back({ Lowered(source), true });
+			break;
+		case 1:
+			patterns.push_back({ MakeWord(random) + "x", false });
+			break;
+		default:
+		{
+			size_t start = random() % (source.size() - 3);
+			size_t length = 3 + random() % 4;
+			patterns.push_back({ Lowered(source.substr(start, length)), false });
+			break;
+		}
+		}
+	}
+
+	// A repeated pattern shares its first copy's bit
+	NameMatcher matcher;
+	std::vector<int> bits;
+	for (const PatternSpec& pattern : patterns)
+		bits.push_back(matcher.Add(pattern.Text, pattern.Exact));
+	matcher.Build();
+
+	// Same answers first
+	for (const std::string& name : names)
+	{
+		NameMatcher::Mask scanned = matcher.Scan(name.c_str());
+		NameMatcher::Mask each = ScanEach(patterns, name);
+		for (size_t i = 0; i < patterns.size(); i++)
+		{
+			if (scanned[bits[i]] != each[i])
+			{
+				printf("mismatch on %s, pattern %s\n", name.c_str(), patterns[i].Text.c_str());
+				return 1;
+			}
+		}
+	}
+
+	double each = MeasureNsPerOp(SpawnCount, [&] {
+		uint64_t hits = 0;
+		for (uint32_t id : spawnNames)
+			hits += ScanEach(patterns, names[id]).count();
+		Consume(hits);
+	}, 5);
+
+	double scan = MeasureNsPerOp(SpawnCount, [&] {
+		uint64_t hits = 0;
+		for (uint32_t id : spawnNames)
+			hits += matcher.Scan(names[id].c_str()).count();
+		Consume(hits);
+	});
+
+	// Scanned on first sight, then looked up, starting cold each run
+	double cached = MeasureNsPerOp(SpawnCount, [&] {
+		std::vector<NameMatcher::Mask> scans(DistinctNames);
+		std::vector<bool> valid(DistinctNames);
+		uint64_t hits = 0;
+		for (uint32_t id : spawnNames)
+		{
+			if (!valid[id])
+			{
+				scans[id] = matcher.Scan(names[id].c_str());
+				valid[id] = true;
+			}
+			hits += scans[id].count();
+		}
+		Consume(hits);
+	});
+
+	PrintHeader("10000 names x 200 patterns (per name)", "per pattern", "candidate");
+	PrintRow("NameMatcher::Scan", each, scan);
+	PrintRow("Scan cached per name", each, cached);
+	return 0;
+}
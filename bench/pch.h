@@ -0,0 +1,10 @@
+/**
+ * @file pch.h
+ * @brief Stands in for the DLL's precompiled header in the benchmarks.
+ * @date 2026-10-17
+ *
+ * The real pch.h pulls in Windows and the proxy. Map sources that need
+ * neither are built against this one instead (-Ibench ahead of the root).
+ */
+
+#pragma once
@@ -0,0 +1,153 @@
+/**
+ * @file pointer_map_bench.cpp
+ * @brief PointerMap against std::map at a busy zone's spawn count.
+ * @date 2026-10-17
+ *
+ * Keys are the addresses of spawn-sized heap blocks, which is what
+ * SpawnMap and the other lookups are keyed by in the game.
+ *
+ *   g++ -std=c++20 -O2 -Imods/map bench/pointer_map_bench.cpp -o pointer_map_bench
+ */
+
+#include "bench.h"
+#include "pointer_map.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr size_t EntryCount = 5000;
+static constexpr size_t SpawnSize = 0x0ebc;    // SpawnAccess::NodeSize
+
+struct Object
+{
+	int Value;
+};
+
+using Key = const char*;
+
+// A map interface over each container, so every case runs the same loop
+struct PointerMapAdapter
+{
+	PointerMap<Key, Object*> Map;
+
+	void Insert(Key key, Object* value) { Map.Insert(key, value); }
+	Object* Find(Key key) const { return Map.Find(key); }
+	bool Erase(Key key) { return Map.Erase(key); }
+};
+
+struct StdMapAdapter
+{
+	std::map<Key, Object*> Map;
+
+	void Insert(Key key, Object* value) { Map[key] = value; }
+	Object* Find(Key key) const
+	{
+		auto it = Map.find(key);
+		return it != Map.end() ? it->second : nullptr;
+	}
+	bool Erase(Key key) { return Map.erase(key) != 0; }
+};
+
+struct Results
+{
+	double Insert;
+	double FindHit;
+	double FindMiss;
+	double Erase;
+	double Churn;
+};
+
+template <typename Adapter>
+static Results Run(const std::vector<Key>& keys, const std::vector<Key>& lookupOrder,
+	const std::vector<Key>& missing, Object* object)
+{
+	Results results;
+
+	results.Insert = MeasureNsPerOp(keys.size(), [&] {
+		Adapter adapter;
+		for (Key key : keys)
+			adapter.Insert(key, object);
+		Consume(reinterpret_cast<uintptr_t>(adapter.Find(keys[0])));
+	});
+
+	Adapter full;
+	for (Key key : keys)
+		full.Insert(key, object);
+
+	results.FindHit = MeasureNsPerOp(lookupOrder.size(), [&] {
+		uint64_t found = 0;
+		for (Key key : lookupOrder)
+			found += full.Find(key) != nullptr;
+		Consume(found);
+	});
+
+	results.FindMiss = MeasureNsPerOp(missing.size(), [&] {
+		uint64_t found = 0;
+		for (Key key : missing)
+			found += full.Find(key) != nullptr;
+		Consume(found);
+	});
+
+	// Each run needs a full container to empty, which isn't timed
+	double best = 1e300;
+	for (int run = 0; run < 15; run++)
+	{
+		Adapter adapter;
+		for (Key key : keys)
+			adapter.Insert(key, object);
+
+		best = std::min(best, MeasureNsPerOp(lookupOrder.size(), [&] {
+			uint64_t erased = 0;
+			for (Key key : lookupOrder)
+				erased += adapter.Erase(key);
+			Consume(erased);
+		}, 1));
+	}
+	results.Erase = best;
+
+	// Spawns despawning and others taking their place, on a full container
+	results.Churn = MeasureNsPerOp(lookupOrder.size() * 2, [&] {
+		for (size_t i = 0; i < lookupOrder.size(); i++)
+		{
+			full.Erase(lookupOrder[i]);
+			full.Insert(lookupOrder[i], object);
+		}
+		Consume(reinterpret_cast<uintptr_t>(full.Find(keys[0])));
+	});
+
+	return results;
+}
+
+int main()
+{
+	std::mt19937 random(12345);
+
+	// Allocated interleaved, so the two sets share address ranges the way
+	// live and despawned spawns do
+	std::vector<std::unique_ptr<char[]>> blocks;
+	std::vector<Key> keys;
+	std::vector<Key> missing;
+	for (size_t i = 0; i < EntryCount * 2; i++)
+	{
+		blocks.emplace_back(new char[SpawnSize]);
+		(i & 1 ? missing : keys).push_back(blocks.back().get());
+	}
+	std::shuffle(keys.begin(), keys.end(), random);
+
+	std::vector<Key> lookupOrder = keys;
+	std::shuffle(lookupOrder.begin(), lookupOrder.end(), random);
+
+	Object object{ 1 };
+	Results stdMap = Run<StdMapAdapter>(keys, lookupOrder, missing, &object);
+	Results pointerMap = Run<PointerMapAdapter>(keys, lookupOrder, missing, &object);
+
+	PrintHeader("PointerMap vs std::map, 5000 entries (per op)", "std::map", "PointerMap");
+	PrintRow("insert", stdMap.Insert, pointerMap.Insert);
+	PrintRow("find (hit)", stdMap.FindHit, pointerMap.FindHit);
+	PrintRow("find (miss)", stdMap.FindMiss, pointerMap.FindMiss);
+	PrintRow("erase", stdMap.Erase, pointerMap.Erase);
+	PrintRow("erase + insert", stdMap.Churn, pointerMap.Churn);
+	return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file spawn_search_bench.cpp
+ * @brief SpawnSearch against SpawnMatchesSearch over a zone of spawns.
+ * @date 2026-10-17
+ *
+ * Builds the real search, name and classification code against the
+ * Win32 stand-ins in bench/host, and runs both over 5000 spawn records
+ * laid out the way SpawnAccess reads them. SpawnSearch is timed twice:
+ * interning the names itself, and given each spawn's NameID the way map
+ * objects pass theirs.
+ *
+ *   g++ -std=c++20 -O2 -fno-exceptions -Ibench/host -I. -Imods/map \
+ *       bench/spawn_search_bench.cpp mq_compat.cpp game_list.cpp \
+ *       mods/map/map_search.cpp mods/map/map_names.cpp mods/map/name_matcher.cpp \
+ *       -o spawn_search_bench
+ */
+
+#include "../pch.h"      // the DLL's, over the stand-ins in bench/host
+#include "bench.h"
+#include "map_search.h"
+
+#include <cstdarg>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr size_t SpawnCount = 5000;
+
+// PlayerClient layout, as documented beside SpawnAccess
+namespace Layout
+{
+	constexpr uintptr_t Y             = 0x064;
+	constexpr uintptr_t X             = 0x068;
+	constexpr uintptr_t Z             = 0x06c;
+	constexpr uintptr_t Name          = 0x0a4;
+	constexpr uintptr_t DisplayedName = 0x0e4;
+	constexpr uintptr_t Type          = 0x125;
+	constexpr uintptr_t SpawnID       = 0x148;
+	constexpr uintptr_t Level         = 0x250;
+}
+
+// ---------------------------------------------------------------------------
+// Host stand-ins for the game state the search code reads
+// ---------------------------------------------------------------------------
+
+static SPAWNINFO* s_localPlayer = nullptr;
+
+void LogFramework(const char*, ...) {}
+
+namespace GameState
+{
+	eqlib::PlayerClient* GetLocalPlayer() { return s_localPlayer; }
+	eqlib::PlayerClient* GetSpawnList() { return nullptr; }
+	eqlib::PlayerManagerClient* GetSpawnManager() { return nullptr; }
+	eqlib::PcClient* GetLocalPC() { return nullptr; }
+	eqlib::ZONEINFO* GetZoneInfo() { return nullptr; }
+}
+
+// ---------------------------------------------------------------------------
+// Spawns
+// ---------------------------------------------------------------------------
+
+template <typename T>
+static void Write(std::vector<char>& record, uintptr_t offset, T value)
+{
+	memcpy(record.data() + offset, &value, sizeof(T));
+}
+
+static void WriteName(std::vector<char>& record, uintptr_t offset, const std::string& name)
+{
+	snprintf(record.data() + offset, EQ_MAX_NAME, "%s", name.c_str());
+}
+
+static const char* s_words[] = {
+	"orc", "gnoll", "rat", "bat", "skeleton", "wolf", "pawn", "guard", "spider",
+	"goblin", "widow", "centurion", "scout", "shaman", "drake", "wisp",
+};
+
+static std::vector<char> MakeSpawn(std::mt19937& random, uint32_t spawnID)
+{
+	std::vector<char> record(SpawnAccess::NodeSize);
+
+	// Names as the client has them: "a_gnoll_pup03" shown as "a gnoll pup"
+	std::string displayed;
+	uint8_t type = SPAWN_NPC;
+	switch (random() % 10)
+	{
+	case 0:
+		type = SPAWN_PLAYER;
+		displayed = std::string(1, static_cast<char>('A' + random() % 26)) + s_words[random() % std::size(s_words)];
+		break;
+	case 1:
+		type = SPAWN_CORPSE;
+		displayed = std::string("a ") + s_words[random() % std::size(s_words)] + "'s corpse";
+		break;
+	case 2:
+		displayed = std::string("Lord ") + s_words[random() % std::size(s_words)];
+		break;
+	default:
+		displayed = std::string("a ") + s_words[random() % std::size(s_words)] + " "
+			+ s_words[random() % std::size(s_words)];
+		break;
+	}
+
+	std::string name = displayed;
+	for (char& c : name)
+		c = c == ' ' ? '_' : c;
+	name += std::to_string(random() % 100);
+
+	WriteName(record, Layout::Name, name);
+	WriteName(record, Layout::DisplayedName, displayed);
+	Write<uint8_t>(record, Layout::Type, type);
+	Write<uint32_t>(record, Layout::SpawnID, spawnID);
+	Write<uint8_t>(record, Layout::Level, static_cast<uint8_t>(1 + random() % 70));
+	Write<float>(record, Layout::X, static_cast<float>(random() % 4000) - 2000.0f);
+	Write<float>(record, Layout::Y, static_cast<float>(random() % 4000) - 2000.0f);
+	Write<float>(record, Layout::Z, static_cast<float>(random() % 200));
+	return record;
+}
+
+static SPAWNINFO* AsSpawn(std::vector<char>& record)
+{
+	return reinterpret_cast<SPAWNINFO*>(record.data());
+}
+
+// ---------------------------------------------------------------------------
+
+int main()
+{
+	std::mt19937 random(12345);
+
+	std::vector<std::vector<char>> records;
+	records.reserve(SpawnCount + 1);
+	for (uint32_t i = 0; i < SpawnCount; i++)
+		records.push_back(MakeSpawn(random, 1000 + i));
+
+	std::vector<SPAWNINFO*> spawns;
+	std::vector<NameID> names;
+	for (auto& record : records)
+	{
+		spawns.push_back(AsSpawn(record));
+		names.push_back(MapNames_Intern(spawns.back()));
+	}
+
+	records.push_back(MakeSpawn(random, 1));
+	s_localPlayer = AsSpawn(records.back());
+
+	const char* searches[] = {
+		"npc",
+		"npc range 20 40",
+		"id 3500",
+		"npc named",
+		"npc orc",
+		"corpse gnoll",
+		"skeleton",
+		"npc radius 500",
+	};
+
+	PrintHeader("5000 spawns (per spawn)", "SpawnMatches", "SpawnSearch");
+	for (const char* text : searches)
+	{
+		MQSpawnSearch search;
+		ClearSearchSpawn(&search);
+		ParseSearchSpawn(text, &search);
+		SpawnSearch compiled(search);
+
+		// Same answers first
+		size_t expected = 0;
+		for (size_t i = 0; i < spawns.size(); i++)
+		{
+			bool matches = SpawnMatchesSearch(&search, spawns[i]);
+			if (matches != compiled.Matches(spawns[i]) || matches != compiled.Matches(spawns[i], names[i]))
+			{
+				printf("mismatch on \"%s\"\n", text);
+				return 1;
+			}
+			expected += matches;
+		}
+
+		double baseline = MeasureNsPerOp(spawns.size(), [&] {
+			uint64_t found = 0;
+			for (SPAWNINFO* pSpawn : spawns)
+				found += SpawnMatchesSearch(&search, pSpawn);
+			Consume(found);
+		});
+
+		double interned = MeasureNsPerOp(spawns.size(), [&] {
+			uint64_t found = 0;
+			for (SPAWNINFO* pSpawn : spawns)
+				found += compiled.Matches(pSpawn);
+			Consume(found);
+		});
+
+		double withName = MeasureNsPerOp(spawns.size(), [&] {
+			uint64_t found = 0;
+			for (size_t i = 0; i < spawns.size(); i++)
+				found += compiled.Matches(spawns[i], names[i]);
+			Consume(found);
+		});
+
+		char row[64];
+		snprintf(row, sizeof(row), "%s (%zu)", text, expected);
+		PrintRow(row, baseline, interned);
+		PrintRow("  given the NameID", baseline, withName);
+	}
+	return 0;
+}
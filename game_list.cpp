@@ -0,0 +1,126 @@
+/**
+ * @file game_list.cpp
+ * @brief Bounded, cycle-safe walks over the game's linked lists.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "game_list.h"
+#include "core.h"
+
+#include <windows.h>
+
+namespace GameList
+{
+
+// ---------------------------------------------------------------------------
+// Walk accounting
+// ---------------------------------------------------------------------------
+
+static WalkStats s_stats;
+
+const WalkStats& GetWalkStats()
+{
+    return s_stats;
+}
+
+void BeginWalk()
+{
+    ++s_stats.Walks;
+}
+
+void EndWalk(WalkEnd end, const void* lastNode, uint32_t count)
+{
+    const char* reason = nullptr;
+    uint32_t total = 0;
+
+    switch (end)
+    {
+    case WalkEnd::Complete:
+        return;
+    case WalkEnd::Bound:
+        reason = "node limit";
+        total = ++s_stats.TruncatedBound;
+        break;
+    case WalkEnd::Cycle:
+        reason = "cycle";
+        total = ++s_stats.TruncatedCycle;
+        break;
+    case WalkEnd::BadPointer:
+        reason = "unreadable node";
+        total = ++s_stats.TruncatedPointer;
+        break;
+    }
+
+    // A broken list tends to stay broken for a while; don't flood the log
+    if (total <= 10 || total % 100 == 0)
+        LogFramework("GameList: walk stopped at %s after %u nodes (node=0x%p, %u so far)",
+            reason, count, lastNode, total);
+}
+
+// ---------------------------------------------------------------------------
+// Readable-range check
+// ---------------------------------------------------------------------------
+
+struct Region
+{
+    uintptr_t Begin = 0;
+    uintptr_t End = 0;
+};
+
+// Game objects come out of a handful of heap segments, so a few cached
+// regions cover nearly every node
+static constexpr size_t RegionCacheSize = 8;
+static Region s_regions[RegionCacheSize];
+static size_t s_nextRegion = 0;
+
+static constexpr DWORD ReadableProtect = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY
+    | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+bool IsReadable(const void* p, size_t size)
+{
+    uintptr_t begin = reinterpret_cast<uintptr_t>(p);
+    uintptr_t end = begin + size;
+
+    // The low 64K is never mapped, and list nodes are pointer aligned
+    if (begin < 0x10000 || end < begin || (begin & (alignof(void*) - 1)) != 0)
+        return false;
+
+    for (const Region& region : s_regions)
+    {
+        if (begin >= region.Begin && end <= region.End)
+            return true;
+    }
+
+    // The range can span several regions; each has to be readable
+    for (uintptr_t address = begin; address < end; )
+    {
+        MEMORY_BASIC_INFORMATION info;
+        if (!VirtualQuery(reinterpret_cast<const void*>(address), &info, sizeof(info)))
+            return false;
+
+        if (info.State != MEM_COMMIT || (info.Protect & (PAGE_GUARD | PAGE_NOACCESS)) != 0
+            || (info.Protect & ReadableProtect) == 0)
+        {
+            return false;
+        }
+
+        Region& region = s_regions[s_nextRegion];
+        s_nextRegion = (s_nextRegion + 1) % RegionCacheSize;
+        region.Begin = reinterpret_cast<uintptr_t>(info.BaseAddress);
+        region.End = region.Begin + info.RegionSize;
+
+        address = region.End;
+    }
+
+    return true;
+}
+
+void FlushRegionCache()
+{
+    for (Region& region : s_regions)
+        region = Region{};
+    s_nextRegion = 0;
+}
+
+} // namespace GameList
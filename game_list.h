@@ -0,0 +1,171 @@
+/**
+ * @file game_list.h
+ * @brief Bounded, cycle-safe walks over the game's linked lists.
+ * @date 2026-10-17
+ *
+ * The spawn list, the ground item list and the property hash chains are
+ * followed through raw pNext pointers. Around a zone transition those can
+ * point at freed memory or loop back on themselves, and a bare while (p)
+ * loop then either faults (caught by SEH, but after doing partial work) or
+ * never finishes. A Walk stops early instead:
+ *
+ *   - after a hard number of nodes,
+ *   - when Brent's algorithm sees the walk come back to an earlier node
+ *     (constant extra memory, at most about two laps into the cycle), or
+ *   - when the next node isn't readable memory.
+ *
+ * Each early stop is counted by reason (see GetWalkStats) and logged, so a
+ * truncated list shows up instead of silently going short.
+ *
+ *   for (SPAWNINFO* pSpawn : GameList::Walk(pSpawnList, &SpawnAccess::GetNext,
+ *           SpawnAccess::NodeSize, GameList::MaxSpawns))
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace GameList
+{
+
+// Hard bounds, well above anything a zone holds
+constexpr uint32_t MaxSpawns      = 16384;
+constexpr uint32_t MaxGroundItems = 8192;
+constexpr uint32_t MaxHashChain   = 256;
+
+enum class WalkEnd : uint8_t
+{
+    Complete,
+    Bound,          // hit the node limit
+    Cycle,          // came back to a node already visited
+    BadPointer,     // next node isn't readable
+};
+
+struct WalkStats
+{
+    uint32_t Walks = 0;
+    uint32_t TruncatedBound = 0;
+    uint32_t TruncatedCycle = 0;
+    uint32_t TruncatedPointer = 0;
+};
+
+const WalkStats& GetWalkStats();
+
+// True if [p, p + size) is pointer aligned, committed and readable. The
+// memory regions seen by earlier checks are cached, so a check is usually
+// just a few compares.
+bool IsReadable(const void* p, size_t size);
+
+// Forget the cached regions. Called when the map is cleared, since a zone
+// transition is when the game gives memory back.
+void FlushRegionCache();
+
+void BeginWalk();
+void EndWalk(WalkEnd end, const void* lastNode, uint32_t count);
+
+// next reads a node's successor. Every node the walk hands out has been
+// checked readable over its first nodeSize bytes.
+template <typename Node, typename Next>
+class Walk
+{
+public:
+    Walk(Node* first, Next next, size_t nodeSize, uint32_t maxNodes)
+        : m_first(first)
+        , m_next(next)
+        , m_nodeSize(nodeSize)
+        , m_maxNodes(maxNodes)
+    {
+    }
+
+    class Iterator
+    {
+    public:
+        Node* operator*() const { return m_node; }
+
+        Iterator& operator++()
+        {
+            Advance(m_walk->m_next(m_node));
+            return *this;
+        }
+
+        bool operator==(std::default_sentinel_t) const { return m_node == nullptr; }
+
+    private:
+        friend class Walk;
+
+        explicit Iterator(const Walk* walk)
+            : m_walk(walk)
+            , m_tortoise(walk->m_first)
+        {
+            BeginWalk();
+            Advance(walk->m_first);
+        }
+
+        void Advance(Node* next)
+        {
+            Node* last = m_node;
+            m_node = nullptr;
+
+            if (!next)
+            {
+                EndWalk(WalkEnd::Complete, last, m_count);
+                return;
+            }
+
+            if (m_count >= m_walk->m_maxNodes)
+            {
+                EndWalk(WalkEnd::Bound, last, m_count);
+                return;
+            }
+
+            // Brent: the tortoise jumps to the hare whenever the hare has
+            // gone a power of two steps past it, so a cycle is caught
+            // within two laps
+            if (m_count > 0)
+            {
+                if (m_power == m_lambda)
+                {
+                    m_tortoise = last;
+                    m_power *= 2;
+                    m_lambda = 0;
+                }
+                ++m_lambda;
+
+                if (next == m_tortoise)
+                {
+                    EndWalk(WalkEnd::Cycle, last, m_count);
+                    return;
+                }
+            }
+
+            if (!IsReadable(next, m_walk->m_nodeSize))
+            {
+                EndWalk(WalkEnd::BadPointer, next, m_count);
+                return;
+            }
+
+            m_node = next;
+            ++m_count;
+        }
+
+        const Walk* m_walk;
+        Node*       m_node = nullptr;
+        Node*       m_tortoise;
+        uint32_t    m_count = 0;
+        uint32_t    m_power = 1;
+        uint32_t    m_lambda = 0;
+    };
+
+    Iterator begin() const { return Iterator(this); }
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    Node*    m_first;
+    Next     m_next;
+    size_t   m_nodeSize;
+    uint32_t m_maxNodes;
+};
+
+} // namespace GameList
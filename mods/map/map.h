@@ -10,8 +10,10 @@
 #pragma once
 
 #include "../../mq_compat.h"
+#include "map_label_template.h"
+#include "map_search.h"
 
-#include <map>
+#include <array>
 #include <vector>
 #include <memory>
 
@@ -62,6 +64,86 @@ enum class MapFilter {
 	Last,
 };
 
+// ---------------------------------------------------------------------------
+// Filter dependency closure
+// ---------------------------------------------------------------------------
+
+// One bit per MapFilter
+using MapFilterMask = uint64_t;
+static_assert(static_cast<int>(MapFilter::Last) <= 64, "MapFilterMask is too small");
+
+constexpr MapFilterMask MapFilterBit(MapFilter filter)
+{
+	return filter == MapFilter::Invalid ? 0 : MapFilterMask(1) << static_cast<int>(filter);
+}
+
+// The RequiresOption column of MapFilterOptions, so the dependency chains
+// can be resolved at compile time. MapFilters_Recompute checks it against
+// the runtime table.
+constexpr MapFilter MapFilterParents[] = {
+	MapFilter::Invalid,     // All
+	MapFilter::All,         // PC
+	MapFilter::PC,          // PCConColor
+	MapFilter::PC,          // Group
+	MapFilter::All,         // Mount
+	MapFilter::All,         // NPC
+	MapFilter::NPC,         // NPCConColor
+	MapFilter::All,         // Untargetable
+	MapFilter::All,         // Pet
+	MapFilter::All,         // Corpse
+	MapFilter::All,         // Chest
+	MapFilter::All,         // Trigger
+	MapFilter::All,         // Trap
+	MapFilter::All,         // Timer
+	MapFilter::All,         // Ground
+	MapFilter::All,         // Target
+	MapFilter::Target,      // TargetLine
+	MapFilter::Target,      // TargetRadius
+	MapFilter::Target,      // TargetMelee
+	MapFilter::All,         // Vector
+	MapFilter::All,         // Custom
+	MapFilter::All,         // CastRadius
+	MapFilter::All,         // NormalLabels
+	MapFilter::All,         // ContextMenu
+	MapFilter::All,         // SpellRadius
+	MapFilter::All,         // Aura
+	MapFilter::All,         // Object
+	MapFilter::All,         // Banner
+	MapFilter::All,         // Campfire
+	MapFilter::Corpse,      // PCCorpse
+	MapFilter::Corpse,      // NPCCorpse
+	MapFilter::All,         // Mercenary
+	MapFilter::NPC,         // Named
+	MapFilter::Target,      // TargetPath
+	MapFilter::All,         // Marker
+	MapFilter::All,         // CampRadius
+	MapFilter::All,         // PullRadius
+};
+static_assert(std::size(MapFilterParents) == static_cast<size_t>(MapFilter::Last),
+	"MapFilterParents must have an entry per MapFilter");
+
+// For each filter, the bits of the filter and everything it requires
+constexpr std::array<MapFilterMask, static_cast<size_t>(MapFilter::Last)> BuildMapFilterClosure()
+{
+	std::array<MapFilterMask, static_cast<size_t>(MapFilter::Last)> closure{};
+
+	for (size_t i = 0; i < closure.size(); i++)
+	{
+		for (MapFilter filter = static_cast<MapFilter>(i); filter != MapFilter::Invalid;
+			filter = MapFilterParents[static_cast<size_t>(filter)])
+		{
+			closure[i] |= MapFilterBit(filter);
+		}
+	}
+
+	return closure;
+}
+
+inline constexpr auto MapFilterClosure = BuildMapFilterClosure();
+
+static_assert(MapFilterClosure[static_cast<size_t>(MapFilter::NPCCorpse)]
+	== (MapFilterBit(MapFilter::NPCCorpse) | MapFilterBit(MapFilter::Corpse) | MapFilterBit(MapFilter::All)));
+
 // ---------------------------------------------------------------------------
 // MapObject forward declaration and alias
 // ---------------------------------------------------------------------------
@@ -138,10 +220,12 @@ extern int HighlightPulseDiff;
 
 extern char MapNameString[MAX_STRING];
 extern char MapTargetNameString[MAX_STRING];
-extern char mapshowStr[MAX_STRING];
-extern char maphideStr[MAX_STRING];
+extern LabelTemplate gMapNameTemplate;
+extern LabelTemplate gMapTargetNameTemplate;
 extern MQSpawnSearch MapFilterCustom;
 extern MQSpawnSearch MapFilterNamed;
+extern SpawnSearch MapFilterCustomSearch;    // compiled from MapFilterCustom
+extern SpawnSearch MapFilterNamedSearch;     // compiled from MapFilterNamed
 
 extern std::vector<MapFilterOption> MapFilterOptions;
 extern MapFilterOption MapFilterInvalidOption;
@@ -149,20 +233,44 @@ extern MapFilterOption MapFilterInvalidOption;
 constexpr int MAX_CLICK_STRINGS = 16;
 extern char MapSpecialClickString[MAX_CLICK_STRINGS][MAX_STRING];
 extern char MapLeftClickString[MAX_CLICK_STRINGS][MAX_STRING];
-extern bool repeatMapshow;
-extern bool repeatMaphide;
+extern LabelTemplate gMapSpecialClickTemplates[MAX_CLICK_STRINGS];
+extern LabelTemplate gMapLeftClickTemplates[MAX_CLICK_STRINGS];
 
 extern std::vector<MapFilterOption*> mapFilterObjectOptions;
 extern std::vector<MapFilterOption*> mapFilterGeneralOptions;
 
-// Linked list globals (defined in map_object.cpp, used by map_api.cpp)
-extern MapObject* gpActiveMapObjects;
+// Game-facing list heads (defined in map_object.cpp). Labels and lines are
+// linked in as they are created and unlinked while parked or deleted.
 extern MapViewLabel* gpLabelList;
 extern MapViewLabel* gpLabelListTail;
 extern MapViewLine* gpLineList;
 extern MapViewLine* gpLineListTail;
 extern MapObject* pLastTarget;
 
+// Per-frame MapUpdate counters. An object is "updated" when its cached
+// inputs changed (or it was invalidated) and "skipped" otherwise; static
+// objects that weren't visited at all count as skipped.
+struct MapUpdateStats
+{
+	int totalObjects = 0;
+	int dynamicObjects = 0;
+	int updatedObjects = 0;
+	int skippedObjects = 0;
+	int removedObjects = 0;
+	int nearObjects = 0;
+	int midObjects = 0;
+	int farObjects = 0;
+	int movedObjects = 0;
+	int culledObjects = 0;
+	int clusterLabels = 0;
+	int clusteredObjects = 0;
+	int fullLabels = 0;
+	int abbreviatedLabels = 0;
+	int budgetHiddenLabels = 0;
+	bool fullPass = false;
+};
+extern MapUpdateStats gMapUpdateStats;
+
 // ---------------------------------------------------------------------------
 // Inline helpers
 // ---------------------------------------------------------------------------
@@ -175,13 +283,22 @@ inline MapFilterOption& GetMapFilterOption(MapFilter Option)
 	return MapFilterOptions[static_cast<size_t>(Option)];
 }
 
+// Effective filter states: a filter's bit is set when it and everything it
+// requires are enabled. Rebuilt by MapFilters_Recompute.
+extern MapFilterMask gMapFilterEffective;
+
+// Call after changing any MapFilterOption::Enabled
+void MapFilters_Recompute();
+
 inline bool IsOptionEnabled(MapFilter Option)
 {
 	if (Option == MapFilter::Invalid)
 		return true;
 
-	MapFilterOption& option = GetMapFilterOption(Option);
-	return option.Enabled && IsOptionEnabled(option.RequiresOption);
+	if (Option < MapFilter::All || Option >= MapFilter::Last)
+		return false;
+
+	return (gMapFilterEffective & MapFilterBit(Option)) != 0;
 }
 
 inline bool RequirementsMet(MapFilter Option)
@@ -201,6 +318,8 @@ MarkerType FindMarker(std::string_view szMark, MarkerType fallback = MarkerType:
 
 PLUGIN_API MapViewLine* InitLine();
 PLUGIN_API void DeleteLine(MapViewLine* pLine);
+MapViewLabel* InitLabel();
+void DeleteLabel(MapViewLabel* pLabel);
 
 // Commands (Phase 7+)
 void MapFilters(PlayerClient* pChar, const char* szLine);
@@ -225,14 +344,26 @@ void SetMapViewMap(void* ptr);
 // INI loading
 void LoadMapSettings();
 
+// Recompile the naming and click templates after any of their strings change
+void MapCompileTemplates();
+
+// Milliseconds per frame MapGenerate may spend creating map objects
+extern float gMapGenerateBudget;
+
 // API
 void MapInit();
 void MapClear();
 void MapGenerate();
+
+// Bring the existing map in line with changed settings: objects the filters
+// no longer allow are removed, the rest are updated in place, and newly
+// allowed spawns are queued like a generate.
+void MapReconcile();
 int MapHighlight(MQSpawnSearch* pSearch);
 int MapHide(MQSpawnSearch& Search);
 int MapShow(MQSpawnSearch& Search);
 void MapUpdate();
+void MapInvalidateObjects();
 void MapAttach();
 void MapDetach();
 
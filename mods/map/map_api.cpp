@@ -3,7 +3,7 @@
  * @brief Map rendering pipeline — ported from MQ2MapAPI.cpp
  * @date 2026-02-09
  *
- * Key functions: MapInit, MapClear, MapGenerate, MapUpdate, MapAttach, MapDetach,
+ * Key functions: MapInit, MapClear, MapGenerate, MapReconcile, MapUpdate, MapAttach, MapDetach,
  * AddSpawn, RemoveSpawn, AddGroundItem, RemoveGroundItem, MapHighlight, MapHide, MapShow.
  *
  * Substitutions from MQ source:
@@ -14,12 +14,20 @@
  */
 
 #include "pch.h"
+#include "map_highlight.h"
 #include "map_object.h"
+#include "map_loc_store.h"
+#include "pointer_map.h"
 
 #include <eqlib/Offsets.h>
 #include <eqlib/offsets/eqgame.h>
 
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 // MapViewMap raw offset access
@@ -115,6 +123,219 @@ static MapObject* GetCurrentMapObject()
 	return GetMapObjectForLabel(pCurrentMapLabel);
 }
 
+// ---------------------------------------------------------------------------
+// Incremental generation — MapGenerate snapshots the spawn and ground item
+// lists nearest to the player first, and MapGenerate_Step turns them into
+// map objects a slice at a time, so zoning in doesn't land in one frame.
+//
+// Spawns destroyed before their turn are dropped from the queue by
+// RemoveSpawn/RemoveGroundItem, and ones that already got an object some
+// other way (add spawn event, target, /mapshow) are skipped.
+// ---------------------------------------------------------------------------
+
+float gMapGenerateBudget = 2.0f;    // milliseconds per frame
+
+static std::vector<SPAWNINFO*> s_pendingSpawns;
+static std::vector<EQGroundItem*> s_pendingGroundItems;
+static size_t s_nextPendingSpawn = 0;
+static size_t s_nextPendingGroundItem = 0;
+
+// Queue position + 1 of each spawn/item still waiting
+static PointerMap<SPAWNINFO*, uint32_t> s_pendingSpawnIndex;
+static PointerMap<EQGroundItem*, uint32_t> s_pendingGroundIndex;
+
+static int s_generateFrames = 0;
+static int s_generatedSpawns = 0;
+static int s_rejectedSpawns = 0;
+static int s_generatedGroundItems = 0;
+
+static bool IsGeneratePending()
+{
+	return s_nextPendingSpawn < s_pendingSpawns.size()
+		|| s_nextPendingGroundItem < s_pendingGroundItems.size();
+}
+
+static void CancelGenerate()
+{
+	s_pendingSpawns.clear();
+	s_pendingGroundItems.clear();
+	s_nextPendingSpawn = 0;
+	s_nextPendingGroundItem = 0;
+	s_pendingSpawnIndex.Clear();
+	s_pendingGroundIndex.Clear();
+}
+
+static void CancelPendingSpawn(SPAWNINFO* pSpawn)
+{
+	if (uint32_t index = s_pendingSpawnIndex.Find(pSpawn))
+	{
+		s_pendingSpawns[index - 1] = nullptr;
+		s_pendingSpawnIndex.Erase(pSpawn);
+	}
+}
+
+static void CancelPendingGroundItem(EQGroundItem* pItem)
+{
+	if (uint32_t index = s_pendingGroundIndex.Find(pItem))
+	{
+		s_pendingGroundItems[index - 1] = nullptr;
+		s_pendingGroundIndex.Erase(pItem);
+	}
+}
+
+// Sort a snapshot nearest-first and index it for cancellation
+template <typename T>
+static void QueueNearestFirst(std::vector<std::pair<float, T*>>& snapshot,
+	std::vector<T*>& queue, PointerMap<T*, uint32_t>& index)
+{
+	std::sort(snapshot.begin(), snapshot.end(),
+		[](const auto& a, const auto& b) { return a.first < b.first; });
+
+	queue.clear();
+	queue.reserve(snapshot.size());
+	index.Reserve(snapshot.size());
+
+	for (const auto& entry : snapshot)
+	{
+		queue.push_back(entry.second);
+		index.Insert(entry.second, static_cast<uint32_t>(queue.size()));
+	}
+}
+
+static void SnapshotSpawnList(SPAWNINFO* pFirst, float focusX, float focusY,
+	std::vector<std::pair<float, SPAWNINFO*>>& snapshot, float& extent)
+{
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	__try
+	{
+		for (SPAWNINFO* pSpawn : WalkSpawns(pFirst))
+		{
+			if (snapshot.size() < 5)
+				LogFramework("  Spawn %u: 0x%p name='%.20s'", static_cast<unsigned int>(snapshot.size() + 1),
+					pSpawn, SpawnAccess::GetName(pSpawn));
+
+			float x = SpawnAccess::GetX(pSpawn);
+			float y = SpawnAccess::GetY(pSpawn);
+			minX = std::min(minX, x); maxX = std::max(maxX, x);
+			minY = std::min(minY, y); maxY = std::max(maxY, y);
+
+			float dx = x - focusX;
+			float dy = y - focusY;
+			snapshot.emplace_back(dx * dx + dy * dy, pSpawn);
+		}
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LogFramework("!!! SnapshotSpawnList EXCEPTION after %u spawns", static_cast<unsigned int>(snapshot.size()));
+	}
+
+	// The spawn bounding box stands in for the zone's size
+	extent = snapshot.empty() ? 0.0f : std::max(maxX - minX, maxY - minY);
+}
+
+static void SnapshotGroundItemList(EQGroundItem* pFirst, float focusX, float focusY,
+	std::vector<std::pair<float, EQGroundItem*>>& snapshot)
+{
+	__try
+	{
+		for (EQGroundItem* pItem : WalkGroundItems(pFirst))
+		{
+			float dx = pItem->X - focusX;
+			float dy = pItem->Y - focusY;
+			snapshot.emplace_back(dx * dx + dy * dy, pItem);
+		}
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LogFramework("!!! SnapshotGroundItemList EXCEPTION after %u items", static_cast<unsigned int>(snapshot.size()));
+	}
+}
+
+// Process queued spawns, then ground items, until the deadline passes.
+// Returns false if a fault abandoned the walk.
+static bool ProcessPendingObjects(bool finish, std::chrono::steady_clock::time_point deadline)
+{
+	SPAWNINFO* pSpawn = nullptr;
+	EQGroundItem* pItem = nullptr;
+	int processed = 0;
+
+	__try
+	{
+		while (s_nextPendingSpawn < s_pendingSpawns.size())
+		{
+			pSpawn = s_pendingSpawns[s_nextPendingSpawn++];
+			if (!pSpawn)
+				continue;
+
+			s_pendingSpawnIndex.Erase(pSpawn);
+
+			if (!FindMapObject(pSpawn))
+			{
+				if (AddSpawn(pSpawn))
+					s_generatedSpawns++;
+				else
+					s_rejectedSpawns++;
+			}
+
+			// Reading the clock isn't free, so only check every few spawns
+			if (!finish && (++processed & 7) == 0 && std::chrono::steady_clock::now() >= deadline)
+				return true;
+		}
+
+		while (s_nextPendingGroundItem < s_pendingGroundItems.size())
+		{
+			pItem = s_pendingGroundItems[s_nextPendingGroundItem++];
+			if (!pItem)
+				continue;
+
+			s_pendingGroundIndex.Erase(pItem);
+
+			if (!FindMapObject(pItem) && AddGroundItem(pItem))
+				s_generatedGroundItems++;
+
+			if (!finish && (++processed & 7) == 0 && std::chrono::steady_clock::now() >= deadline)
+				return true;
+		}
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LogFramework("!!! MapGenerate EXCEPTION in pending walk, code=0x%08X, lastSpawn=0x%p lastItem=0x%p",
+			GetExceptionCode(), pSpawn, pItem);
+		return false;
+	}
+
+	return true;
+}
+
+// Work through the queue within the frame budget, or all of it if finish
+// is set. Returns true while work remains.
+static bool MapGenerate_Step(bool finish = false)
+{
+	if (!IsGeneratePending())
+		return false;
+
+	auto budget = std::chrono::duration<float, std::milli>(gMapGenerateBudget);
+	auto deadline = std::chrono::steady_clock::now()
+		+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+
+	s_generateFrames++;
+
+	if (!ProcessPendingObjects(finish, deadline))
+		CancelGenerate();
+
+	if (IsGeneratePending())
+		return true;
+
+	LogFramework("MapGenerate: complete over %d frames — %d map objects, %d rejected, %d ground items",
+		s_generateFrames, s_generatedSpawns, s_rejectedSpawns, s_generatedGroundItems);
+
+	LogFramework("MapGenerate: ready (gpLabelList=0x%p gpLineList=0x%p)",
+		gpLabelList, gpLineList);
+
+	CancelGenerate();
+	return false;
+}
+
 // ---------------------------------------------------------------------------
 // MapInit / MapClear
 // ---------------------------------------------------------------------------
@@ -129,13 +350,9 @@ void MapInit()
 	PullCircle.Clear();
 }
 
-void MapClear()
+// The target line and range circles are rebuilt by MapUpdate as needed
+static void ClearOverlays()
 {
-	ClearBodyTypeCache();
-	MapObjects_Clear();
-
-	pLastTarget = nullptr;
-
 	if (pTargetLine)
 	{
 		DeleteLine(pTargetLine);
@@ -150,6 +367,22 @@ void MapClear()
 	PullCircle.Clear();
 }
 
+void MapClear()
+{
+	CancelGenerate();
+	MapSearch_Clear();
+	MapObjects_Clear();
+	MapRules_ClearHidden();
+	ClearSpawnClassCache();
+	MapNames_Clear();
+	GameList::FlushRegionCache();
+
+	pLastTarget = nullptr;
+	ClearOverlays();
+
+	MapObjects_ReleaseStorage();
+}
+
 // ---------------------------------------------------------------------------
 // AddSpawn / RemoveSpawn / AddGroundItem / RemoveGroundItem
 // ---------------------------------------------------------------------------
@@ -161,13 +394,18 @@ MapObject* AddSpawn(SPAWNINFO* pNewSpawn, bool ExplicitAllow)
 
 bool RemoveSpawn(SPAWNINFO* pSpawn)
 {
-	MapObject* pMapObject = FindMapObject(pSpawn);
-	if (pMapObject)
+	CancelPendingSpawn(pSpawn);
+
+	bool removed = false;
+	if (MapObject* pMapObject = FindMapObject(pSpawn))
 	{
 		RemoveMapObject(pMapObject);  // handles detach/attach internally
-		return true;
+		removed = true;
 	}
-	return false;
+
+	// Deleting the object can record the spawn as hidden, so this goes after
+	MapRules_OnSpawnRemoved(pSpawn);
+	return removed;
 }
 
 MapObject* AddGroundItem(EQGroundItem* pGroundItem)
@@ -177,6 +415,8 @@ MapObject* AddGroundItem(EQGroundItem* pGroundItem)
 
 void RemoveGroundItem(EQGroundItem* pGroundItem)
 {
+	CancelPendingGroundItem(pGroundItem);
+
 	if (MapObject* mapObject = FindMapObject(pGroundItem))
 	{
 		RemoveMapObject(mapObject);  // handles detach/attach internally
@@ -187,8 +427,91 @@ void RemoveGroundItem(EQGroundItem* pGroundItem)
 // MapGenerate
 // ---------------------------------------------------------------------------
 
+// Kept out of MapGenerate, whose snapshot vectors can't share a frame with
+// __try. Returns nullptr if the first spawn can't be read.
+static SPAWNINFO* DumpFirstSpawn(SPAWNINFO* pSpawn)
+{
+	uintptr_t base = reinterpret_cast<uintptr_t>(pSpawn);
+	__try
+	{
+		// Dump first 0x14 bytes to see TListNode + CActorApplicationData vtable
+		LogFramework("  First spawn raw dump (0x%p):", pSpawn);
+		for (int i = 0; i < 5; i++)
+		{
+			uint32_t val = *reinterpret_cast<uint32_t*>(base + i * 4);
+			LogFramework("    [+0x%02X] = 0x%08X", i * 4, val);
+		}
+		uint8_t  type    = *reinterpret_cast<uint8_t*>(base + 0x125);
+		uint16_t spawnID = *reinterpret_cast<uint16_t*>(base + 0x148);
+		LogFramework("    type=%d spawnID=%d name='%.30s'", type, spawnID, SpawnAccess::GetName(pSpawn));
+
+		// Also dump the spawn manager to check first/last pointers
+		void* mgr = reinterpret_cast<void*>(GameState::GetSpawnManager());
+		if (mgr)
+		{
+			uintptr_t mgrBase = reinterpret_cast<uintptr_t>(mgr);
+			LogFramework("  SpawnManager (0x%p) raw dump:", mgr);
+			for (int i = 0; i < 6; i++)
+			{
+				uint32_t val = *reinterpret_cast<uint32_t*>(mgrBase + i * 4);
+				LogFramework("    [+0x%02X] = 0x%08X", i * 4, val);
+			}
+		}
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LogFramework("!!! Cannot read first spawn at 0x%p — code=0x%08X", pSpawn, GetExceptionCode());
+		return nullptr;
+	}
+
+	return pSpawn;
+}
+
+// Snapshot the spawn and ground item lists and queue them nearest first.
+// Anything that already has a map object is skipped when its turn comes.
+static void QueueZoneObjects(SPAWNINFO* pSpawn)
+{
+	// Nearest first, so the player's surroundings show up straight away
+	float focusX = 0.0f;
+	float focusY = 0.0f;
+	if (SPAWNINFO* localPlayer = pLocalPlayer)
+	{
+		focusX = SpawnAccess::GetX(localPlayer);
+		focusY = SpawnAccess::GetY(localPlayer);
+	}
+
+	std::vector<std::pair<float, SPAWNINFO*>> spawnSnapshot;
+	float zoneExtent = 0.0f;
+	SnapshotSpawnList(pSpawn, focusX, focusY, spawnSnapshot, zoneExtent);
+	MapLod_SetZoneExtent(zoneExtent);
+
+	std::vector<std::pair<float, EQGroundItem*>> groundSnapshot;
+	if (IsOptionEnabled(MapFilter::Ground))
+	{
+		EQGroundItem* pItem = GameState::GetGroundItemListTop();
+		LogFramework("MapGenerate: ground items top=0x%p", pItem);
+		SnapshotGroundItemList(pItem, focusX, focusY, groundSnapshot);
+	}
+
+	// Size the spawn/ground/label lookup tables for the whole zone up front
+	MapObjects_Reserve(spawnSnapshot.size(), groundSnapshot.size());
+
+	QueueNearestFirst(spawnSnapshot, s_pendingSpawns, s_pendingSpawnIndex);
+	QueueNearestFirst(groundSnapshot, s_pendingGroundItems, s_pendingGroundIndex);
+
+	s_generateFrames = 0;
+	s_generatedSpawns = 0;
+	s_rejectedSpawns = 0;
+	s_generatedGroundItems = 0;
+
+	LogFramework("MapGenerate: queued %u spawns, %u ground items",
+		static_cast<unsigned int>(s_pendingSpawns.size()), static_cast<unsigned int>(s_pendingGroundItems.size()));
+}
+
 void MapGenerate()
 {
+	CancelGenerate();
+
 	if (!IsOptionEnabled(MapFilter::All))
 	{
 		LogFramework("MapGenerate: All filter disabled, skipping");
@@ -209,118 +532,63 @@ void MapGenerate()
 		IsOptionEnabled(MapFilter::Mount) ? 1 : 0,
 		IsOptionEnabled(MapFilter::Untargetable) ? 1 : 0);
 
-	int spawnCount = 0;
-	int spawnObjectCount = 0;
-	int groundCount = 0;
-	int typeCountPC = 0, typeCountNPC = 0, typeCountMount = 0, typeCountPet = 0;
-	int typeCountCorpse = 0, typeCountUntarget = 0, typeCountOther = 0;
-	int rejectedCount = 0;
-
 	SPAWNINFO* pSpawn = pSpawnList;
 	LogFramework("MapGenerate: pSpawnList=0x%p", pSpawn);
 
 	// Diagnostic: dump first spawn's TListNode and manager to diagnose list traversal
 	if (pSpawn)
-	{
-		uintptr_t base = reinterpret_cast<uintptr_t>(pSpawn);
-		__try
-		{
-			// Dump first 0x14 bytes to see TListNode + CActorApplicationData vtable
-			LogFramework("  First spawn raw dump (0x%p):", pSpawn);
-			for (int i = 0; i < 5; i++)
-			{
-				uint32_t val = *reinterpret_cast<uint32_t*>(base + i * 4);
-				LogFramework("    [+0x%02X] = 0x%08X", i * 4, val);
-			}
-			uint8_t  type    = *reinterpret_cast<uint8_t*>(base + 0x125);
-			uint16_t spawnID = *reinterpret_cast<uint16_t*>(base + 0x148);
-			LogFramework("    type=%d spawnID=%d name='%.30s'", type, spawnID, SpawnAccess::GetName(pSpawn));
+		pSpawn = DumpFirstSpawn(pSpawn);
 
-			// Also dump the spawn manager to check first/last pointers
-			void* mgr = reinterpret_cast<void*>(GameState::GetSpawnManager());
-			if (mgr)
-			{
-				uintptr_t mgrBase = reinterpret_cast<uintptr_t>(mgr);
-				LogFramework("  SpawnManager (0x%p) raw dump:", mgr);
-				for (int i = 0; i < 6; i++)
-				{
-					uint32_t val = *reinterpret_cast<uint32_t*>(mgrBase + i * 4);
-					LogFramework("    [+0x%02X] = 0x%08X", i * 4, val);
-				}
-			}
-		}
-		__except (EXCEPTION_EXECUTE_HANDLER)
-		{
-			LogFramework("!!! Cannot read first spawn at 0x%p — code=0x%08X", pSpawn, GetExceptionCode());
-			pSpawn = nullptr;
-		}
-	}
+	QueueZoneObjects(pSpawn);
+	MapLocStore_SyncZone();
+	CreateAllMapLocs();
 
-	__try
-	{
-		while (pSpawn)
-		{
-			spawnCount++;
-			if (spawnCount <= 5)
-				LogFramework("  Spawn %d: 0x%p name='%.20s'", spawnCount, pSpawn, SpawnAccess::GetName(pSpawn));
-
-			eSpawnType sType = GetSpawnType(pSpawn);
-			switch (sType) {
-			case PC: typeCountPC++; break;
-			case NPC: typeCountNPC++; break;
-			case MOUNT: typeCountMount++; break;
-			case PET: case PCPET: case NPCPET: typeCountPet++; break;
-			case CORPSE: case NPCCORPSE: case PCCORPSE: typeCountCorpse++; break;
-			case UNTARGETABLE: typeCountUntarget++; break;
-			default: typeCountOther++; break;
-			}
+	// First slice right away; MapUpdate picks up the rest
+	MapGenerate_Step();
+}
 
-			if (AddSpawn(pSpawn))
-				spawnObjectCount++;
-			else
-				rejectedCount++;
+// ---------------------------------------------------------------------------
+// MapReconcile
+// ---------------------------------------------------------------------------
 
-			pSpawn = SpawnAccess::GetNext(pSpawn);
-		}
-	}
-	__except (EXCEPTION_EXECUTE_HANDLER)
+void MapReconcile()
+{
+	if (!IsOptionEnabled(MapFilter::All))
 	{
-		LogFramework("!!! MapGenerate EXCEPTION in spawn walk after %d spawns, code=0x%08X, lastSpawn=0x%p",
-			spawnCount, GetExceptionCode(), pSpawn);
+		MapClear();
+		return;
 	}
 
-	LogFramework("MapGenerate: spawn walk done — %d spawns, %d objects, %d rejected", spawnCount, spawnObjectCount, rejectedCount);
-	LogFramework("MapGenerate: types — PC=%d NPC=%d Mount=%d Pet=%d Corpse=%d Untarget=%d Other=%d",
-		typeCountPC, typeCountNPC, typeCountMount, typeCountPet, typeCountCorpse, typeCountUntarget, typeCountOther);
+	CancelGenerate();
+	ClearOverlays();
 
-	if (IsOptionEnabled(MapFilter::Ground))
-	{
-		EQGroundItem* pItem = GameState::GetGroundItemListTop();
-		LogFramework("MapGenerate: ground items top=0x%p", pItem);
+	// Keep what the current filters still allow and bring it up to date in
+	// place; only objects that are no longer wanted are deleted.
+	int kept = 0;
+	int removed = 0;
 
-		__try
+	MapObjects_ForEach([&](MapObject* mapObject) {
+		if (mapObject->CanDisplayObject())
 		{
-			while (pItem)
-			{
-				AddGroundItem(pItem);
-				pItem = pItem->pNext;
-				groundCount++;
-			}
+			mapObject->Reconcile();
+			kept++;
 		}
-		__except (EXCEPTION_EXECUTE_HANDLER)
+		else
 		{
-			LogFramework("!!! MapGenerate EXCEPTION in ground item walk after %d items, code=0x%08X",
-				groundCount, GetExceptionCode());
+			RemoveMapObject(mapObject);
+			removed++;
 		}
-	}
+	});
 
-	CreateAllMapLocs();
+	// One full pass, so clusters and the label budget are redone too
+	MapInvalidateObjects();
 
-	LogFramework("MapGenerate: complete — %d spawns walked, %d map objects, %d ground items",
-		spawnCount, spawnObjectCount, groundCount);
+	LogFramework("MapReconcile: kept %d map objects, removed %d", kept, removed);
 
-	LogFramework("MapGenerate: ready (gpLabelList=0x%p gpLineList=0x%p)",
-		gpLabelList, gpLineList);
+	// Spawns and items the filters now allow are added like a generate
+	QueueZoneObjects(pSpawnList);
+	CreateAllMapLocs();
+	MapGenerate_Step();
 }
 
 // ---------------------------------------------------------------------------
@@ -339,12 +607,15 @@ void MapUpdate()
 	}
 	EnterMQ2Benchmark(bmMapRefresh);
 
+	// Continue a MapGenerate that is still working through the zone
+	MapGenerate_Step();
+	MapSearch_Update();
+	MapRules_Update();
+	MapHighlight_Update();
+
 	SPAWNINFO* localPlayer = pLocalPlayer;
 	SPAWNINFO* target = pTarget;
 
-	bool bTargetChanged = false;
-	MapObject* pOldLastTarget = pLastTarget;
-
 	// Check if current target is obsolete
 	if (pLastTarget && pLastTarget->GetSpawn() != target)
 	{
@@ -352,14 +623,20 @@ void MapUpdate()
 		{
 			RemoveMapObject(pLastTarget);
 		}
+		else
+		{
+			// Rebuild with the normal name string and color
+			pLastTarget->Invalidate();
+		}
 
 		pLastTarget = nullptr;
-		bTargetChanged = true;
 	}
 
 	// Update target with new
 	if (target && IsOptionEnabled(MapFilter::Target))
 	{
+		MapObject* pOldTarget = pLastTarget;
+
 		if (MapObject* pMapObject = FindMapObject(target))
 		{
 			pLastTarget = pMapObject;
@@ -373,35 +650,29 @@ void MapUpdate()
 		{
 			pLastTarget = AddSpawn(target);
 		}
-	}
 
-	int totalObjects = 0, removedObjects = 0;
-	MapObject* mapObject = gpActiveMapObjects;
-	while (mapObject)
-	{
-		totalObjects++;
-		bool forced = (mapObject == pOldLastTarget) && bTargetChanged;
-		mapObject->Update(forced);
-
-		if (!mapObject->CanDisplayObject())
-		{
-			removedObjects++;
-			MapObject* pNext = mapObject->GetNext();
-			RemoveMapObject(mapObject);
-			mapObject = pNext;
-		}
-		else
+		if (pLastTarget && pLastTarget != pOldTarget)
 		{
-			mapObject = mapObject->GetNext();
+			pLastTarget->Invalidate();
 		}
 	}
 
+	MapObjects_Update(gMapUpdateStats);
+	const MapUpdateStats& stats = gMapUpdateStats;
+
 	s_updateCount++;
-	if (s_updateCount <= 5 || (removedObjects > 0 && s_updateCount % 300 == 0))
+	if (s_updateCount <= 5 || s_updateCount % 300 == 0)
 	{
-		LogFramework("MapUpdate #%d: pLocalPC=0x%p total=%d removed=%d remaining=%d target=0x%p",
-			s_updateCount, (void*)pLocalPC, totalObjects, removedObjects,
-			totalObjects - removedObjects, (void*)target);
+		LogFramework("MapUpdate #%d: pLocalPC=0x%p total=%d dynamic=%d updated=%d skipped=%d removed=%d lod=%d/%d/%d moved=%d culled=%d clusters=%d/%d labels=%d/%d/%d%s target=0x%p",
+			s_updateCount, (void*)pLocalPC, stats.totalObjects, stats.dynamicObjects,
+			stats.updatedObjects, stats.skippedObjects, stats.removedObjects,
+			stats.nearObjects, stats.midObjects, stats.farObjects, stats.movedObjects,
+			stats.culledObjects, stats.clusterLabels, stats.clusteredObjects,
+			stats.fullLabels, stats.abbreviatedLabels, stats.budgetHiddenLabels, stats.fullPass ? " (full pass)" : "", (void*)target);
+
+		const GameList::WalkStats& walks = GameList::GetWalkStats();
+		LogFramework("MapUpdate #%d: list walks=%u truncated bound=%u cycle=%u pointer=%u",
+			s_updateCount, walks.Walks, walks.TruncatedBound, walks.TruncatedCycle, walks.TruncatedPointer);
 	}
 
 	// Cast radius circle
@@ -583,29 +854,25 @@ void MapDetach()
 
 int MapHighlight(MQSpawnSearch* pSearch)
 {
+	// Highlights apply to everything on the map, so finish building it
+	MapGenerate_Step(true);
+
 	if (!pSearch)
 	{
-		MapObject* pMapSpawn = gpActiveMapObjects;
-		while (pMapSpawn)
-		{
-			pMapSpawn->SetHighlight(false);
-			pMapSpawn = pMapSpawn->GetNext();
-		}
+		MapHighlight_Reset();
 		return 0;
 	}
 
 	uint32_t Count = 0;
-	MAPSPAWN* pMapSpawn = gpActiveMapObjects;
+	uint32_t defaultSet = HighlightSetBit(DefaultHighlightSet);
 
-	while (pMapSpawn)
+	for (SPAWNINFO* pSpawn : MapSearch_Find(*pSearch))
 	{
-		SPAWNINFO* pSpawn = pMapSpawn->GetSpawn();
-		if (pSpawn && SpawnMatchesSearch(pSearch, pLocalPlayer, pSpawn))
+		if (MapObject* pMapSpawn = FindMapObject(pSpawn))
 		{
-			pMapSpawn->SetHighlight(true);
+			pMapSpawn->SetHighlightSets(pMapSpawn->GetHighlightSets() | defaultSet);
 			Count++;
 		}
-		pMapSpawn = pMapSpawn->GetNext();
 	}
 
 	return Count;
@@ -613,23 +880,17 @@ int MapHighlight(MQSpawnSearch* pSearch)
 
 int MapHide(MQSpawnSearch& Search)
 {
-	MapObject* pMapSpawn = gpActiveMapObjects;
+	MapGenerate_Step(true);
+
 	uint32_t Count = 0;
 
-	while (pMapSpawn)
+	for (SPAWNINFO* pSpawn : MapSearch_Find(Search))
 	{
-		SPAWNINFO* pSpawn = pMapSpawn->GetSpawn();
-		if (pSpawn && SpawnMatchesSearch(&Search, pLocalPlayer, pSpawn))
+		if (MapObject* pMapSpawn = FindMapObject(pSpawn))
 		{
-			MapObject* pNext = pMapSpawn->GetNext();
 			RemoveMapObject(pMapSpawn);
-			pMapSpawn = pNext;
 			Count++;
 		}
-		else
-		{
-			pMapSpawn = pMapSpawn->GetNext();
-		}
 	}
 
 	return Count;
@@ -637,18 +898,15 @@ int MapHide(MQSpawnSearch& Search)
 
 int MapShow(MQSpawnSearch& Search)
 {
-	SPAWNINFO* pSpawn = pSpawnList;
 	uint32_t Count = 0;
 
-	while (pSpawn)
+	for (SPAWNINFO* pSpawn : MapSearch_Find(Search))
 	{
-		if (FindMapObject(pSpawn) == nullptr
-			&& SpawnMatchesSearch(&Search, pLocalPlayer, pSpawn))
+		if (FindMapObject(pSpawn) == nullptr)
 		{
 			AddSpawn(pSpawn, true);
 			Count++;
 		}
-		pSpawn = SpawnAccess::GetNext(pSpawn);
 	}
 
 	return Count;
@@ -664,47 +922,29 @@ void MapClickLocation(float x, float y, float z)
 	if (modKeys < 0 || modKeys >= MAX_CLICK_STRINGS)
 		return;
 
-	if (MapLeftClickString[modKeys][0] == 0)
+	const LabelTemplate& command = gMapLeftClickTemplates[modKeys];
+	if (command.Empty())
+	{
+		// With nothing bound to the click, it picks map locs for
+		// /maploc remove selected
+		if (MapLocTemplate* mapLoc = MapLocStore_FindAt(x, y))
+			mapLoc->SetSelected(!mapLoc->IsSelected());
 		return;
-
-	char szCommand[MAX_STRING];
-	strcpy_s(szCommand, MapLeftClickString[modKeys]);
+	}
 
 	// Substitute %x, %y, %z placeholders with world coordinates
-	char xBuf[64], yBuf[64], zBuf[64];
-	snprintf(xBuf, sizeof(xBuf), "%.2f", x);
-	snprintf(yBuf, sizeof(yBuf), "%.2f", y);
-	snprintf(zBuf, sizeof(zBuf), "%.2f", z);
-
-	char szOutput[MAX_STRING] = { 0 };
-	char* pOut = szOutput;
-	char* pEnd = szOutput + sizeof(szOutput) - 1;
-	for (const char* p = szCommand; *p && pOut < pEnd; )
+	char szOutput[MAX_STRING];
+	LabelWriter out(szOutput, sizeof(szOutput));
+	command.Format(out, [&](char spec, LabelWriter& writer)
 	{
-		if (*p == '%' && *(p + 1))
+		switch (spec)
 		{
-			const char* sub = nullptr;
-			switch (*(p + 1))
-			{
-			case 'x': sub = xBuf; break;
-			case 'y': sub = yBuf; break;
-			case 'z': sub = zBuf; break;
-			}
-			if (sub)
-			{
-				size_t len = strlen(sub);
-				if (pOut + len < pEnd)
-				{
-					memcpy(pOut, sub, len);
-					pOut += len;
-				}
-				p += 2;
-				continue;
-			}
+		case 'x': writer.AppendFixed(x, 2); return true;
+		case 'y': writer.AppendFixed(y, 2); return true;
+		case 'z': writer.AppendFixed(z, 2); return true;
+		default: return false;
 		}
-		*pOut++ = *p++;
-	}
-	*pOut = 0;
+	});
 
 	EzCommand(szOutput);
 }
@@ -732,51 +972,23 @@ bool MapSelectTarget()
 		LogFramework("MapSelectTarget: targeted '%s' (id=%u)", SpawnAccess::GetName(pSpawn), SpawnAccess::GetSpawnID(pSpawn));
 	}
 	else if (modKeys > 0 && modKeys < MAX_CLICK_STRINGS
-		&& MapSpecialClickString[modKeys][0] != 0)
+		&& !gMapSpecialClickTemplates[modKeys].Empty())
 	{
 		// With modifiers — substitute placeholders and execute command
-		char szCommand[MAX_STRING];
-		strcpy_s(szCommand, MapSpecialClickString[modKeys]);
-
-		const char* name = SpawnAccess::GetName(pSpawn);
-		char idBuf[32];
-		snprintf(idBuf, sizeof(idBuf), "%u", SpawnAccess::GetSpawnID(pSpawn));
-		char xBuf[64], yBuf[64], zBuf[64];
-		snprintf(xBuf, sizeof(xBuf), "%.2f", SpawnAccess::GetX(pSpawn));
-		snprintf(yBuf, sizeof(yBuf), "%.2f", SpawnAccess::GetY(pSpawn));
-		snprintf(zBuf, sizeof(zBuf), "%.2f", SpawnAccess::GetZ(pSpawn));
-
-		char szOutput[MAX_STRING] = { 0 };
-		char* pOut = szOutput;
-		char* pOutEnd = szOutput + sizeof(szOutput) - 1;
-		for (const char* p = szCommand; *p && pOut < pOutEnd; )
-		{
-			if (*p == '%' && *(p + 1))
+		char szOutput[MAX_STRING];
+		LabelWriter out(szOutput, sizeof(szOutput));
+		gMapSpecialClickTemplates[modKeys].Format(out, [pSpawn](char spec, LabelWriter& writer)
+		{
+			switch (spec)
 			{
-				const char* sub = nullptr;
-				switch (*(p + 1))
-				{
-				case 'n': sub = name; break;
-				case 'i': sub = idBuf; break;
-				case 'x': sub = xBuf; break;
-				case 'y': sub = yBuf; break;
-				case 'z': sub = zBuf; break;
-				}
-				if (sub)
-				{
-					size_t len = strlen(sub);
-					if (pOut + len < pOutEnd)
-					{
-						memcpy(pOut, sub, len);
-						pOut += len;
-					}
-					p += 2;
-					continue;
-				}
+			case 'n': writer.Append(SpawnAccess::GetName(pSpawn)); return true;
+			case 'i': writer.AppendNumber(SpawnAccess::GetSpawnID(pSpawn)); return true;
+			case 'x': writer.AppendFixed(SpawnAccess::GetX(pSpawn), 2); return true;
+			case 'y': writer.AppendFixed(SpawnAccess::GetY(pSpawn), 2); return true;
+			case 'z': writer.AppendFixed(SpawnAccess::GetZ(pSpawn), 2); return true;
+			default: return false;
 			}
-			*pOut++ = *p++;
-		}
-		*pOut = 0;
+		});
 
 		EzCommand(szOutput);
 	}
@@ -816,7 +1028,8 @@ void MapLocSyntaxOutput()
 	SyntaxError("Usage: /maploc [[size 10-200] | [width 1-10] | [color r g b] | [radius <distance>] | [rcolor r g b] | [yloc xloc (zloc) | target]] | [label text]");
 	SyntaxError(" -- Omit locs to set defaults");
 	SyntaxError(" -- Add label to loc by putting 'label <my text here>' only at end of command");
-	SyntaxError("Remove maplocs: /maploc remove [index | [yloc xloc (zloc)]]");
+	SyntaxError("Remove maplocs: /maploc remove [index | [yloc xloc (zloc)] | selected]");
+	SyntaxError(" -- Click a maploc on the map to select it");
 	WriteChatf("MapLoc Defaults: Width:%.0f, Size:%.0f, Color:%d,%d,%d, Radius:%.0f, Radius Color:%d,%d,%d",
 		gDefaultMapLocParams.width,
 		gDefaultMapLocParams.lineSize,
@@ -846,6 +1059,15 @@ void MapRemoveLocation(const char* szLine)
 
 	ss >> arg;
 
+	if (ci_equals(arg, "selected"))
+	{
+		int count = static_cast<int>(std::count_if(gMapLocTemplates.begin(), gMapLocTemplates.end(),
+			[](const auto& mapLoc) { return mapLoc->IsSelected(); }));
+		DeleteSelectedMapLocs();
+		WriteChatf("%d MapLoc(s) removed", count);
+		return;
+	}
+
 	if (!IsFloat(arg))
 	{
 		MapLocSyntaxOutput();
@@ -0,0 +1,243 @@
+/**
+ * @file map_cluster.cpp
+ * @brief Folds overlapping map labels into cluster count labels.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_cluster.h"
+#include "map_object.h"
+#include "map_view.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Settings
+// ---------------------------------------------------------------------------
+
+bool gMapClusterEnabled = true;
+
+static float s_cellSize = 48.0f;    // screen pixels
+static int s_minCount = 4;
+static int s_interval = 15;         // frames
+
+void LoadMapClusterSettings()
+{
+	gMapClusterEnabled = GetPrivateProfileBool("Map Clustering", "Enabled", gMapClusterEnabled, INIFileName);
+	s_cellSize = std::max(1.0f, GetPrivateProfileFloat("Map Clustering", "CellSize", s_cellSize, INIFileName));
+	s_minCount = std::max(2, GetPrivateProfileInt("Map Clustering", "MinCount", s_minCount, INIFileName));
+	s_interval = std::max(1, GetPrivateProfileInt("Map Clustering", "Interval", s_interval, INIFileName));
+}
+
+// ---------------------------------------------------------------------------
+// Cluster labels
+// ---------------------------------------------------------------------------
+
+struct ClusterLabel
+{
+	MAPLABEL* Label = nullptr;
+	char      Text[32] = {};
+};
+
+// Heap allocated so the text a label points at never moves
+static std::vector<std::unique_ptr<ClusterLabel>> s_clusterLabels;
+static size_t s_clusterLabelCount = 0;
+
+static ClusterLabel& AcquireClusterLabel()
+{
+	if (s_clusterLabelCount == s_clusterLabels.size())
+	{
+		auto cluster = std::make_unique<ClusterLabel>();
+		cluster->Label = InitLabel();
+		cluster->Label->Size = 3;
+		cluster->Label->Width = 20;
+		cluster->Label->Height = 14;
+		cluster->Label->OffsetX = 0;
+		cluster->Label->OffsetY = 0;
+		cluster->Label->Label = cluster->Text;
+		s_clusterLabels.push_back(std::move(cluster));
+	}
+
+	return *s_clusterLabels[s_clusterLabelCount++];
+}
+
+// Delete labels that weren't used by the last pass
+static void TrimClusterLabels()
+{
+	while (s_clusterLabels.size() > s_clusterLabelCount)
+	{
+		DeleteLabel(s_clusterLabels.back()->Label);
+		s_clusterLabels.pop_back();
+	}
+}
+
+static const char* GetClusterNoun(MapFilter filter)
+{
+	switch (filter)
+	{
+	case MapFilter::PC:
+		return "pcs";
+	case MapFilter::NPC:
+	case MapFilter::Named:
+		return "npcs";
+	case MapFilter::Corpse:
+		return "corpses";
+	case MapFilter::Ground:
+		return "items";
+	case MapFilter::Pet:
+		return "pets";
+	default:
+		return "spawns";
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Grid pass
+// ---------------------------------------------------------------------------
+
+struct ClusterEntry
+{
+	uint64_t   Cell;
+	MapObject* Object;
+};
+
+static std::vector<ClusterEntry> s_entries;
+static int s_framesSincePass = 0;
+static bool s_hasClusters = false;
+static int s_clusteredObjectCount = 0;
+static float s_passScale = 0.0f;    // zoom the last pass was made at
+
+static void BuildCluster(const ClusterEntry* first, const ClusterEntry* last)
+{
+	MapFilter filter = first->Object->GetMapFilter();
+	CVector3 sum;
+
+	for (const ClusterEntry* entry = first; entry != last; ++entry)
+	{
+		MapObject* mapObject = entry->Object;
+		mapObject->SetLabelHidden(LabelHide_Clustered, true);
+
+		if (filter != MapFilter::Invalid && mapObject->GetMapFilter() != filter)
+			filter = MapFilter::Invalid;
+
+		CVector3 pos = mapObject->GetPosition();
+		sum.X += pos.X;
+		sum.Y += pos.Y;
+		sum.Z += pos.Z;
+	}
+
+	int count = static_cast<int>(last - first);
+	ClusterLabel& cluster = AcquireClusterLabel();
+
+	snprintf(cluster.Text, sizeof(cluster.Text), "%d %s", count, GetClusterNoun(filter));
+
+	MAPLABEL* pLabel = cluster.Label;
+	pLabel->Location.X = -sum.X / count;
+	pLabel->Location.Y = -sum.Y / count;
+	pLabel->Location.Z = sum.Z / count;
+	pLabel->Color.ARGB = first->Object->GetColor().ToARGB();
+	pLabel->Layer = activeLayer;
+}
+
+void MapCluster_Update(bool force, MapUpdateStats& stats)
+{
+	if (!gMapClusterEnabled)
+	{
+		if (s_hasClusters)
+			MapCluster_Clear();
+		return;
+	}
+
+	// Nothing to size the cells by until the view has been measured
+	float scale = MapView_GetScale();
+	if (scale <= 0.0f)
+	{
+		if (s_hasClusters)
+			MapCluster_Clear();
+		return;
+	}
+
+	if (scale != s_passScale)
+		force = true;
+
+	if (!force && ++s_framesSincePass < s_interval)
+	{
+		stats.clusterLabels = static_cast<int>(s_clusterLabelCount);
+		stats.clusteredObjects = s_clusteredObjectCount;
+		return;
+	}
+
+	s_framesSincePass = 0;
+	s_clusteredObjectCount = 0;
+	s_passScale = scale;
+	s_entries.clear();
+
+	float cellWorld = s_cellSize * scale;
+
+	MapObjects_ForEach([&](MapObject* mapObject) {
+		// The target and highlighted spawns always keep their own label
+		if (!mapObject->HasLabel() || mapObject->IsCulled()
+			|| mapObject == pLastTarget || mapObject->IsHighlighted())
+		{
+			mapObject->SetLabelHidden(LabelHide_Clustered, false);
+			return;
+		}
+
+		CVector3 pos = mapObject->GetPosition();
+		int32_t cellX = static_cast<int32_t>(floorf(pos.X / cellWorld));
+		int32_t cellY = static_cast<int32_t>(floorf(pos.Y / cellWorld));
+
+		uint64_t cell = (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+		s_entries.push_back({ cell, mapObject });
+	});
+
+	std::sort(s_entries.begin(), s_entries.end(),
+		[](const ClusterEntry& a, const ClusterEntry& b) { return a.Cell < b.Cell; });
+
+	s_clusterLabelCount = 0;
+
+	const ClusterEntry* entries = s_entries.data();
+	size_t count = s_entries.size();
+	for (size_t start = 0; start < count; )
+	{
+		size_t end = start + 1;
+		while (end < count && entries[end].Cell == entries[start].Cell)
+			end++;
+
+		if (static_cast<int>(end - start) >= s_minCount)
+		{
+			BuildCluster(entries + start, entries + end);
+			s_clusteredObjectCount += static_cast<int>(end - start);
+		}
+		else
+		{
+			for (size_t i = start; i < end; i++)
+				entries[i].Object->SetLabelHidden(LabelHide_Clustered, false);
+		}
+
+		start = end;
+	}
+
+	TrimClusterLabels();
+
+	s_hasClusters = s_clusterLabelCount != 0;
+	stats.clusterLabels = static_cast<int>(s_clusterLabelCount);
+	stats.clusteredObjects = s_clusteredObjectCount;
+}
+
+void MapCluster_Clear()
+{
+	s_clusterLabelCount = 0;
+	TrimClusterLabels();
+
+	MapObjects_ForEach([](MapObject* mapObject) { mapObject->SetLabelHidden(LabelHide_Clustered, false); });
+
+	s_entries.clear();
+	s_framesSincePass = 0;
+	s_hasClusters = false;
+	s_clusteredObjectCount = 0;
+	s_passScale = 0.0f;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file map_cluster.h
+ * @brief Folds overlapping map labels into cluster count labels.
+ * @date 2026-10-17
+ *
+ * In a dense zone the zoomed-out map is a pile of overlapping names. Every
+ * few frames, and whenever the view or the zoom changes, labels are
+ * bucketed into a grid whose cells are CellSize screen pixels (about one
+ * label box) at the current zoom, as measured by map_view.cpp. Cells
+ * holding MinCount or more labels hide them and show a single "12 npcs"
+ * label at their centroid instead. Zooming in shrinks the cells in world
+ * units, so clusters break back up into their labels. Markers are left
+ * alone, and the target and highlighted spawns always keep their own label.
+ *
+ * Until the zoom has been measured once, nothing is clustered.
+ *
+ * INI ([Map Clustering]):
+ *   Enabled, CellSize, MinCount, Interval
+ */
+
+#pragma once
+
+#include "map.h"
+
+extern bool gMapClusterEnabled;
+
+void LoadMapClusterSettings();
+
+// Called at the end of MapObjects_Update. Regroups labels when the interval
+// has elapsed, the zoom changed, or force is set (the view or the object
+// set changed).
+void MapCluster_Update(bool force, MapUpdateStats& stats);
+
+// Delete every cluster label and show all hidden object labels
+void MapCluster_Clear();
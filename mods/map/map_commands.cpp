@@ -17,6 +17,10 @@
 
 #include "pch.h"
 #include "map_object.h"
+#include "map_view.h"
+#include "map_cluster.h"
+#include "map_highlight.h"
+#include "map_loc_store.h"
 
 #include <sstream>
 #include <algorithm>
@@ -114,6 +118,7 @@ void MapFilterSetting(PlayerClient* pChar, MapFilter nMapFilter, const char* szV
 				pMapFilter->Enabled = !pMapFilter->Enabled;
 			}
 
+			MapFilters_Recompute();
 			WriteChatf("%s is now set to: %s", pMapFilter->szName, szFilterMap[IsOptionEnabled(nMapFilter)]);
 		}
 		else if (nMapFilter == MapFilter::Custom)
@@ -131,6 +136,8 @@ void MapFilterSetting(PlayerClient* pChar, MapFilter nMapFilter, const char* szV
 
 				WriteChatf("%s is now set to: %s", pMapFilter->szName, FormatSearchSpawn(Buff, sizeof(Buff), &MapFilterCustom));
 			}
+
+			MapFilterCustomSearch.Compile(MapFilterCustom);
 		}
 		else if (nMapFilter == MapFilter::Marker)
 		{
@@ -140,11 +147,13 @@ void MapFilterSetting(PlayerClient* pChar, MapFilter nMapFilter, const char* szV
 			if (!_stricmp(szFilterMap[0], szValue))
 			{
 				pMapFilter->Enabled = false;
+				MapFilters_Recompute();
 				WriteChatf("%s is now set to: %s", pMapFilter->szName, szFilterMap[IsOptionEnabled(nMapFilter)]);
 			}
 			else if (!_stricmp(szFilterMap[1], szValue))
 			{
 				pMapFilter->Enabled = true;
+				MapFilters_Recompute();
 				WriteChatf("%s is now set to: %s", pMapFilter->szName, szFilterMap[IsOptionEnabled(nMapFilter)]);
 			}
 			else
@@ -157,6 +166,7 @@ void MapFilterSetting(PlayerClient* pChar, MapFilter nMapFilter, const char* szV
 
 	if (szValue)
 	{
+		MapFilters_Recompute();
 		WritePrivateProfileBool("Map Filters", pMapFilter->szName, pMapFilter->Enabled, INIFileName);
 	}
 }
@@ -210,6 +220,7 @@ static void MapFilterRadiusSetting(SPAWNINFO* pChar, MapFilter nMapFilter, const
 	MapFilterOption* option = &MapFilterOptions[static_cast<size_t>(nMapFilter)];
 	option->Radius = GetFloatFromString(szValue, 0.0f);
 	option->Enabled = option->Radius > 0.0f;
+	MapFilters_Recompute();
 
 	if (option->Radius > 0.0f && !_stricmp(option->szName, "CampRadius"))
 	{
@@ -293,8 +304,12 @@ void MapFilters(PlayerClient* pChar, const char* szLine)
 		}
 		else if (Found->IsRegenerateOnChange())
 		{
-			MapClear();
-			MapGenerate();
+			MapReconcile();
+		}
+		else
+		{
+			// Toggles and colors can change how any object is drawn
+			MapInvalidateObjects();
 		}
 	}
 }
@@ -318,8 +333,113 @@ void MapActiveLayerCmd(PlayerClient* pChar, const char* szLine)
 
 	WritePrivateProfileInt("Map Filters", "ActiveLayer", activeLayer, INIFileName);
 
-	MapClear();
-	MapGenerate();
+	MapReconcile();
+}
+
+// ---------------------------------------------------------------------------
+// Highlight sets — /highlight set|remove|list
+// ---------------------------------------------------------------------------
+
+static void ListHighlightSets()
+{
+	for (size_t i = 0; i < MaxHighlightSets; i++)
+	{
+		const HighlightSet& set = MapHighlight_GetSet(i);
+		if (!set.Active)
+			continue;
+
+		char expiry[64] = { 0 };
+		if (set.ExpiresAt)
+		{
+			uint64_t now = GetTickCount64();
+			uint64_t left = set.ExpiresAt > now ? (set.ExpiresAt - now) / 1000 : 0;
+			snprintf(expiry, sizeof(expiry), ", expires in %us", static_cast<unsigned int>(left));
+		}
+
+		WriteChatf("  %s: %s (color %d %d %d%s%s)", set.Name.c_str(),
+			set.Text.empty() ? "/highlight <spawnfilter>" : set.Text.c_str(),
+			set.Color.Red, set.Color.Green, set.Color.Blue, set.Pulse ? ", pulse" : "", expiry);
+	}
+}
+
+static void MapHighlightSetCmd(const char* szLine)
+{
+	char szName[MAX_STRING] = { 0 };
+	char szArg[MAX_STRING] = { 0 };
+
+	GetArg(szName, szLine, 2);
+	GetArg(szArg, szLine, 3);
+	if (!szName[0] || !szArg[0])
+	{
+		SyntaxError("Usage: /highlight set <name> <spawnfilter>|color # # #|pulse|expire <seconds>");
+		return;
+	}
+
+	int index = MapHighlight_FindSet(szName);
+
+	// Settings of an existing set
+	bool isColor = !_stricmp(szArg, "color");
+	bool isPulse = !_stricmp(szArg, "pulse");
+	bool isExpire = !_stricmp(szArg, "expire");
+	if (isColor || isPulse || isExpire)
+	{
+		if (index < 0)
+		{
+			WriteChatf("No highlight set '%s'", szName);
+			return;
+		}
+
+		if (isColor)
+		{
+			char red[64], green[64], blue[64];
+			GetArg(red, szLine, 4);
+			GetArg(green, szLine, 5);
+			GetArg(blue, szLine, 6);
+
+			int R = GetIntFromString(red, -1);
+			int G = GetIntFromString(green, -1);
+			int B = GetIntFromString(blue, -1);
+			if (R < 0 || R > 255 || G < 0 || G > 255 || B < 0 || B > 255)
+			{
+				SyntaxError("Usage: /highlight set <name> color [0-255] [0-255] [0-255]");
+				return;
+			}
+
+			MapHighlight_SetColor(index, MQColor(static_cast<uint8_t>(R), static_cast<uint8_t>(G), static_cast<uint8_t>(B)));
+			WriteChatf("Highlight set '%s' color: %d %d %d", szName, R, G, B);
+		}
+		else if (isPulse)
+		{
+			bool pulse = !MapHighlight_GetSet(index).Pulse;
+			MapHighlight_SetPulse(index, pulse);
+			WriteChatf("Highlight set '%s' pulse: %s", szName, pulse ? "ON" : "OFF");
+		}
+		else
+		{
+			GetArg(szArg, szLine, 4);
+			int seconds = GetIntFromString(szArg, -1);
+			if (seconds < 0 || index == DefaultHighlightSet)
+			{
+				SyntaxError("Usage: /highlight set <name> expire <seconds> (0 = never)");
+				return;
+			}
+
+			MapHighlight_SetExpiry(index, static_cast<uint32_t>(seconds));
+			WriteChatf("Highlight set '%s' expires: %s", szName, seconds ? szArg : "never");
+		}
+		return;
+	}
+
+	int matched = 0;
+	index = MapHighlight_SetSearch(szName, GetNextArg(szLine, 2), matched);
+	if (index < 0)
+	{
+		WriteChatf("Highlight set '%s' not made: the name is taken by the default set, all %u sets are in use, "
+			"or the search uses a radius", szName, static_cast<unsigned int>(MaxHighlightSets));
+		return;
+	}
+
+	WriteChatf("Highlight set '%s': %d mapped spawns highlighted", szName, matched);
 }
 
 // ---------------------------------------------------------------------------
@@ -336,7 +456,7 @@ void MapHighlightCmd(PlayerClient* pChar, const char* szLine)
 
 	if (szLine[0] == 0)
 	{
-		SyntaxError("Usage: /highlight [reset|spawnfilter|size|pulse|[color # # #]]");
+		SyntaxError("Usage: /highlight [reset|spawnfilter|size|pulse|[color # # #]|set|remove|list]");
 		return;
 	}
 
@@ -386,6 +506,7 @@ void MapHighlightCmd(PlayerClient* pChar, const char* szLine)
 		unsigned char G = static_cast<unsigned char>(GetIntFromString(green, 255));
 		unsigned char B = static_cast<unsigned char>(GetIntFromString(blue, 255));
 		HighlightColor = MQColor(R, G, B);
+		MapHighlight_DefaultSettingsChanged();
 
 		WriteChatf("Highlight color: %d %d %d", R, G, B);
 
@@ -398,6 +519,31 @@ void MapHighlightCmd(PlayerClient* pChar, const char* szLine)
 		WriteChatColor("Highlighting reset");
 		return;
 	}
+	else if (!_stricmp(szArg, "set"))
+	{
+		MapHighlightSetCmd(szLine);
+		return;
+	}
+	else if (!_stricmp(szArg, "remove"))
+	{
+		ss >> szArg;
+		int index = MapHighlight_FindSet(szArg);
+		if (index < 0)
+		{
+			WriteChatf("No highlight set '%s'", szArg);
+			return;
+		}
+
+		MapHighlight_RemoveSet(index);
+		WriteChatf("Highlight set '%s' removed", szArg);
+		return;
+	}
+	else if (!_stricmp(szArg, "list"))
+	{
+		WriteChatColor("Highlight sets:");
+		ListHighlightSets();
+		return;
+	}
 	else if (!_stricmp(szArg, "size"))
 	{
 		if (ss && !ss.eof())
@@ -418,6 +564,7 @@ void MapHighlightCmd(PlayerClient* pChar, const char* szLine)
 
 		HighlightSIDELEN = GetIntFromString(szArg, HighlightSIDELEN);
 		PulseReset();
+		MapInvalidateObjects();
 
 		WriteChatf("Highlight size: %d", HighlightSIDELEN);
 
@@ -428,6 +575,7 @@ void MapHighlightCmd(PlayerClient* pChar, const char* szLine)
 	{
 		HighlightPulse = !HighlightPulse;
 		PulseReset();
+		MapHighlight_DefaultSettingsChanged();
 
 		WriteChatf("Highlight pulse: %s", HighlightPulse ? "ON" : "OFF");
 
@@ -457,90 +605,112 @@ void PulseReset()
 }
 
 // ---------------------------------------------------------------------------
-// MapHideCmd — /maphide command handler
+// MapRuleCmd — shared body of /maphide and /mapshow
 // ---------------------------------------------------------------------------
 
-void MapHideCmd(PlayerClient* pChar, const char* szLine)
+static void ListMapRules()
+{
+	const std::vector<MapRule>& rules = MapRules_Get();
+	if (rules.empty())
+	{
+		WriteChatColor("No map rules");
+		return;
+	}
+
+	WriteChatColor("Map rules (last match wins):");
+	for (const MapRule& rule : rules)
+		WriteChatf("  %u: %s %s", rule.ID, MapRules_GetActionName(rule.Action), rule.Text.c_str());
+}
+
+static void MapRuleCmd(MapRuleAction action, const char* szCommand, const char* szLine)
 {
 	char szArg[MAX_STRING] = { 0 };
 
 	if (szLine == nullptr || szLine[0] == 0)
 	{
-		SyntaxError("Usage: /maphide [spawnfilter|reset|repeat]");
+		SyntaxError("Usage: %s [spawnfilter|list|remove #|clear|reset]", szCommand);
 		return;
 	}
 
 	GetArg(szArg, szLine, 1);
+	// Undoes this command's rules as well as its one-off hides or shows
 	if (!_stricmp(szArg, "reset"))
 	{
+		int removed = MapRules_Clear(action);
 		MapClear();
 		MapGenerate();
-		WriteChatColor("Map spawns regenerated");
+		WriteChatf("%d %s rules removed, map spawns regenerated", removed, MapRules_GetActionName(action));
 		return;
 	}
 
-	if (!_stricmp(szArg, "repeat"))
+	if (!_stricmp(szArg, "list"))
 	{
-		repeatMaphide = !repeatMaphide;
-
-		WritePrivateProfileInt("Map Filters", "Maphide-Repeat", repeatMaphide, INIFileName);
-
-		WriteChatf("maphide repeat set to: %s", (repeatMaphide ? "on" : "off"));
+		ListMapRules();
 		return;
 	}
 
-	if (pLocalPlayer)
+	if (!_stricmp(szArg, "remove"))
 	{
-		MQSpawnSearch ssHide;
-		ClearSearchSpawn(&ssHide);
-		ParseSearchSpawn(szLine, &ssHide);
-
-		WriteChatf("%d mapped spawns hidden", MapHide(ssHide));
-	}
-}
-
-// ---------------------------------------------------------------------------
-// MapShowCmd — /mapshow command handler
-// ---------------------------------------------------------------------------
-
-void MapShowCmd(PlayerClient* pChar, const char* szLine)
-{
-	char szArg[MAX_STRING] = { 0 };
+		GetArg(szArg, szLine, 2);
+		int id = GetIntFromString(szArg, 0);
+		if (id <= 0)
+		{
+			SyntaxError("Usage: %s remove #", szCommand);
+			return;
+		}
 
-	if (szLine == nullptr || szLine[0] == 0)
-	{
-		SyntaxError("Usage: /mapshow [spawnfilter|reset|repeat]");
+		if (MapRules_Remove(static_cast<uint32_t>(id)))
+			WriteChatf("Map rule %d removed", id);
+		else
+			WriteChatf("No map rule %d", id);
 		return;
 	}
 
-	GetArg(szArg, szLine, 1);
-	if (!_stricmp(szArg, "reset"))
+	if (!_stricmp(szArg, "clear"))
 	{
-		MapClear();
-		MapGenerate();
-
-		WriteChatColor("Map spawns regenerated");
+		int removed = MapRules_Clear(action);
+		WriteChatf("%d %s rules removed", removed, MapRules_GetActionName(action));
 		return;
 	}
 
-	if (!_stricmp(szArg, "repeat"))
+	if (pLocalPlayer)
 	{
-		repeatMapshow = !repeatMapshow;
+		int changed = 0;
+		if (const MapRule* rule = MapRules_Add(action, szLine, changed))
+		{
+			WriteChatf("Map rule %u: %s %s (%d spawns %s)", rule->ID, MapRules_GetActionName(action),
+				szLine, changed, action == MapRuleAction::Hide ? "hidden" : "shown");
+			return;
+		}
 
-		WritePrivateProfileBool("Map Filters", "Mapshow-Repeat", repeatMapshow, INIFileName);
+		// A radius or location can't be kept as a rule; apply it once
+		MQSpawnSearch search;
+		ClearSearchSpawn(&search);
+		ParseSearchSpawn(szLine, &search);
 
-		WriteChatf("mapshow repeat set to: %s", (repeatMapshow ? "on" : "off"));
-		return;
+		if (action == MapRuleAction::Hide)
+			WriteChatf("%d mapped spawns hidden (once: radius searches aren't kept)", MapHide(search));
+		else
+			WriteChatf("%d previously hidden spawns shown (once: radius searches aren't kept)", MapShow(search));
 	}
+}
 
-	if (pLocalPlayer)
-	{
-		MQSpawnSearch ssShow;
-		ClearSearchSpawn(&ssShow);
-		ParseSearchSpawn(szLine, &ssShow);
+// ---------------------------------------------------------------------------
+// MapHideCmd — /maphide command handler
+// ---------------------------------------------------------------------------
 
-		WriteChatf("%d previously hidden spawns shown", MapShow(ssShow));
-	}
+void MapHideCmd(PlayerClient* pChar, const char* szLine)
+{
+	MapRuleCmd(MapRuleAction::Hide, "/maphide", szLine);
+}
+
+// ---------------------------------------------------------------------------
+// MapShowCmd — /mapshow command handler
+// ---------------------------------------------------------------------------
+
+void MapShowCmd(PlayerClient* pChar, const char* szLine)
+{
+	MapRuleCmd(MapRuleAction::Show, "/mapshow", szLine);
 }
 
 // ---------------------------------------------------------------------------
@@ -570,8 +740,8 @@ void MapNames(PlayerClient* pChar, const char* szLine)
 		WriteChatf("Target naming string: %s", MapTargetNameString);
 
 		WritePrivateProfileString("Naming Schemes", "Target", MapTargetNameString, INIFileName);
-		MapClear();
-		MapGenerate();
+		MapCompileTemplates();
+		MapReconcile();
 	}
 	else if (!_stricmp(szArg, "normal"))
 	{
@@ -583,8 +753,8 @@ void MapNames(PlayerClient* pChar, const char* szLine)
 		WriteChatf("Normal naming string: %s", MapNameString);
 
 		WritePrivateProfileString("Naming Schemes", "Normal", MapNameString, INIFileName);
-		MapClear();
-		MapGenerate();
+		MapCompileTemplates();
+		MapReconcile();
 	}
 	else
 	{
@@ -638,6 +808,7 @@ void MapClickCommand(PlayerClient* pChar, const char* szLine)
 		if (!_stricmp(szRest, "clear"))
 		{
 			command_array[combo][0] = 0;
+			MapCompileTemplates();
 			char keyBuf[32];
 			snprintf(keyBuf, sizeof(keyBuf), "KeyCombo%d", combo);
 			WritePrivateProfileString(szSection, keyBuf, command_array[combo], INIFileName);
@@ -647,6 +818,7 @@ void MapClickCommand(PlayerClient* pChar, const char* szLine)
 		}
 
 		strcpy_s(command_array[combo], szRest);
+		MapCompileTemplates();
 		char keyBuf[32];
 		snprintf(keyBuf, sizeof(keyBuf), "KeyCombo%d", combo);
 		WritePrivateProfileString(szSection, keyBuf, command_array[combo], INIFileName);
@@ -744,6 +916,9 @@ char* FormatMarker(const char* szLine, char* szDest, size_t BufferSize)
 
 void MapSetLocationCmd(PlayerClient* pChar, const char* szLine)
 {
+	// Locs belong to the zone; make sure its saved ones are loaded first
+	MapLocStore_SyncZone();
+
 	char szArg[MAX_STRING] = { 0 };
 	if (szLine && szLine[0])
 		GetArg(szArg, szLine, 1);
@@ -986,9 +1161,7 @@ void LoadMapSettings()
 
 	InitDefaultMapLocParams();
 	ResetMapLocOverrides();
-
-	repeatMapshow = GetPrivateProfileBool("Map Filters", "Mapshow-Repeat", false, INIFileName);
-	repeatMaphide = GetPrivateProfileBool("Map Filters", "Maphide-Repeat", false, INIFileName);
+	LoadMapLocStoreSettings();
 
 	HighlightSIDELEN = GetPrivateProfileInt("Map Filters", "HighSize", HighlightSIDELEN, INIFileName);
 	HighlightPulse = GetPrivateProfileBool("Map Filters", "HighPulse", HighlightPulse, INIFileName);
@@ -996,12 +1169,18 @@ void LoadMapSettings()
 	HighlightPulseIncreasing = true;
 	HighlightPulseIndex = 0;
 	HighlightPulseDiff = HighlightSIDELEN / 10;
+	MapHighlight_DefaultSettingsChanged();
+
+	gMapCircleSegmentLength = std::max(1.0f, GetPrivateProfileFloat("Map Filters", "CircleSegmentLength", gMapCircleSegmentLength, INIFileName));
+	gMapGenerateBudget = std::max(0.1f, GetPrivateProfileFloat("Map Generate", "TimeBudget", gMapGenerateBudget, INIFileName));
 
-	// Load mapshow/maphide filter strings
-	std::string mapshowINI = GetPrivateProfileString("Map Filters", "Mapshow", "", INIFileName);
-	strcpy_s(mapshowStr, mapshowINI.c_str());
-	std::string maphideINI = GetPrivateProfileString("Map Filters", "Maphide", "", INIFileName);
-	strcpy_s(maphideStr, maphideINI.c_str());
+	LoadMapLodSettings();
+	LoadMapMotionSettings();
+	LoadMapViewSettings();
+	LoadMapClusterSettings();
+	LoadMapLabelBudgetSettings();
+
+	LoadMapRules();
 
 	// Load naming schemes
 	std::string normalName = GetPrivateProfileString("Naming Schemes", "Normal", "%N", INIFileName);
@@ -1020,12 +1199,16 @@ void LoadMapSettings()
 		strcpy_s(MapLeftClickString[i], leftClick.c_str());
 	}
 
+	MapCompileTemplates();
+
 	// Custom filter: do not use since the string isn't stored
 	MapFilterOptions[static_cast<size_t>(MapFilter::Custom)].Enabled = false;
+	MapFilters_Recompute();
 
 	// Named filter setup
 	ClearSearchSpawn(&MapFilterNamed);
 	ParseSearchSpawn("#", &MapFilterNamed);
+	MapFilterNamedSearch.Compile(MapFilterNamed);
 
 	LogFramework("LoadMapSettings: complete (layer=%d, naming='%s'/'%s')", activeLayer, MapNameString, MapTargetNameString);
 }
@@ -0,0 +1,209 @@
+/**
+ * @file map_geometry.cpp
+ * @brief Shared trig tables and marker geometry.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_geometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Heading trig table
+// ---------------------------------------------------------------------------
+
+struct HeadingTable
+{
+	SinCos Entries[HeadingTableSize];
+
+	HeadingTable()
+	{
+		for (int i = 0; i < HeadingTableSize; i++)
+		{
+			float radians = static_cast<float>(i) / HeadingTableSize * 2.0f * PI;
+			Entries[i] = { sinf(radians), cosf(radians) };
+		}
+	}
+};
+
+static const HeadingTable s_headingTable;
+
+const SinCos& GetHeadingSinCos(float heading)
+{
+	constexpr float unitsPerHeading = HeadingTableSize / 512.0f;
+	int index = static_cast<int>(floorf(heading * unitsPerHeading + 0.5f));
+	return s_headingTable.Entries[index & (HeadingTableSize - 1)];
+}
+
+// ---------------------------------------------------------------------------
+// Unit circles
+// ---------------------------------------------------------------------------
+
+float gMapCircleSegmentLength = 20.0f;
+
+static std::vector<SinCos> s_unitCircles[MaxCircleSegments + 1];
+
+int GetCircleSegments(float radius)
+{
+	// Clamped before the cast, since a huge or NaN radius doesn't fit an int
+	float segments = ceilf(2.0f * PI * radius / gMapCircleSegmentLength);
+	if (!(segments > MinCircleSegments))
+		return MinCircleSegments;
+	if (segments >= MaxCircleSegments)
+		return MaxCircleSegments;
+
+	// Round up to a multiple of four so circles share a few unit tables
+	return (static_cast<int>(segments) + 3) & ~3;
+}
+
+const SinCos* GetUnitCircle(int segments)
+{
+	segments = std::clamp(segments, MinCircleSegments, MaxCircleSegments);
+
+	std::vector<SinCos>& circle = s_unitCircles[segments];
+	if (circle.empty())
+	{
+		circle.resize(segments + 1);
+		for (int i = 0; i < segments; i++)
+		{
+			float radians = static_cast<float>(i) / segments * 2.0f * PI;
+			circle[i] = { sinf(radians), cosf(radians) };
+		}
+		circle[segments] = circle[0];
+	}
+
+	return circle.data();
+}
+
+// ---------------------------------------------------------------------------
+// Marker templates
+// ---------------------------------------------------------------------------
+
+// Unit vertex at an angle in degrees, measured the way headings are: sin
+// gives X, cos gives Y.
+static void SetVertexAtAngle(MarkerTemplate& shape, int index, float degrees)
+{
+	shape.U[index] = sinf(degrees / 180.0f * PI);
+	shape.V[index] = cosf(degrees / 180.0f * PI);
+}
+
+struct MarkerTemplates
+{
+	MarkerTemplate Triangle;
+	MarkerTemplate Square;
+	MarkerTemplate Diamond;
+	MarkerTemplate Ring;
+	MarkerTemplate None;
+
+	MarkerTemplates()
+	{
+		// Nose points along the heading, with the back corners 150 degrees
+		// either side of it
+		Triangle.VertexCount = 3;
+		Triangle.Rotates = true;
+		SetVertexAtAngle(Triangle, 0, 180.0f);
+		SetVertexAtAngle(Triangle, 1, 30.0f);
+		SetVertexAtAngle(Triangle, 2, 330.0f);
+
+		static constexpr float squareU[] = { -1.0f, 1.0f, 1.0f, -1.0f };
+		static constexpr float squareV[] = { -1.0f, -1.0f, 1.0f, 1.0f };
+		Square.VertexCount = 4;
+		for (int i = 0; i < 4; i++)
+		{
+			Square.U[i] = squareU[i];
+			Square.V[i] = squareV[i];
+		}
+
+		static constexpr float diamondU[] = { 0.0f, 1.0f, 0.0f, -1.0f };
+		static constexpr float diamondV[] = { -1.0f, 0.0f, 1.0f, 0.0f };
+		Diamond.VertexCount = 4;
+		for (int i = 0; i < 4; i++)
+		{
+			Diamond.U[i] = diamondU[i];
+			Diamond.V[i] = diamondV[i];
+		}
+
+		Ring.VertexCount = 8;
+		for (int i = 0; i < 8; i++)
+			SetVertexAtAngle(Ring, i, i * 45 + 22.5f);
+	}
+};
+
+static const MarkerTemplates s_markerTemplates;
+
+const MarkerTemplate& GetMarkerTemplate(MarkerType type)
+{
+	switch (type)
+	{
+	case MarkerType::Triangle: return s_markerTemplates.Triangle;
+	case MarkerType::Square: return s_markerTemplates.Square;
+	case MarkerType::Diamond: return s_markerTemplates.Diamond;
+	case MarkerType::Ring: return s_markerTemplates.Ring;
+	default: return s_markerTemplates.None;
+	}
+}
+
+int GetMarkerLineCount(MarkerType type)
+{
+	return GetMarkerTemplate(type).VertexCount;
+}
+
+// Distance from the centre to a unit vertex, per shape
+static float GetMarkerScale(MarkerType type, uint32_t sideLength)
+{
+	switch (type)
+	{
+	case MarkerType::Triangle: return (sideLength * 1.5f) * sqrtf(3) / 3;
+	case MarkerType::Square: return static_cast<float>(sideLength / 2);
+	case MarkerType::Diamond: return sideLength * .71f;
+	case MarkerType::Ring: return static_cast<float>(sideLength);
+	default: return 0.0f;
+	}
+}
+
+static SinCos GetMarkerRotation(const MarkerTemplate& shape, float heading)
+{
+	if (!shape.Rotates)
+		return { 0.0f, 1.0f };
+
+	return GetHeadingSinCos(heading);
+}
+
+static void WriteMarkerLine(MapViewLine* line, float x0, float y0, float x1, float y1, float z, uint32_t color)
+{
+	line->Start.X = x0;
+	line->Start.Y = y0;
+	line->End.X = x1;
+	line->End.Y = y1;
+	line->Start.Z = z;
+	line->End.Z = z;
+
+	if (line->Color.ARGB != color)
+		line->Color.ARGB = color;
+}
+
+void BuildMarker(const MarkerGeometry& geometry, MapViewLine* const* lines)
+{
+	const MarkerTemplate& shape = GetMarkerTemplate(geometry.Type);
+	if (shape.VertexCount == 0)
+		return;
+
+	float scale = GetMarkerScale(geometry.Type, geometry.SideLength);
+	SinCos rotation = GetMarkerRotation(shape, geometry.Heading);
+
+	float x[MaxMarkerVertices], y[MaxMarkerVertices];
+	for (int v = 0; v < shape.VertexCount; v++)
+	{
+		x[v] = geometry.X + scale * (shape.U[v] * rotation.Cos + shape.V[v] * rotation.Sin);
+		y[v] = geometry.Y + scale * (shape.V[v] * rotation.Cos - shape.U[v] * rotation.Sin);
+	}
+
+	for (int v = 0; v < shape.VertexCount; v++)
+	{
+		int next = (v + 1) % shape.VertexCount;
+		WriteMarkerLine(lines[v], x[v], y[v], x[next], y[next], geometry.Z, geometry.ColorARGB);
+	}
+}
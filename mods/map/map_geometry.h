@@ -0,0 +1,87 @@
+/**
+ * @file map_geometry.h
+ * @brief Shared trig tables and marker geometry.
+ * @date 2026-10-17
+ *
+ * Every marker shape is a closed polygon: a handful of unit vertices that
+ * are scaled, optionally rotated by the spawn's heading and translated to
+ * its map position. Heading rotations come from a lookup table instead of
+ * sinf/cosf per vertex.
+ *
+ * Map circles use cached unit circles per segment count, so moving or
+ * resizing one is a scale and translate.
+ */
+
+#pragma once
+
+#include "map.h"
+
+// ---------------------------------------------------------------------------
+// Heading trig table
+// ---------------------------------------------------------------------------
+
+// EQ headings run 0..512 per revolution; the table has two entries per unit
+constexpr int HeadingTableSize = 1024;
+
+struct SinCos
+{
+	float Sin;
+	float Cos;
+};
+
+// Sin/cos of a heading in EQ units (0..512), quantized to the table
+const SinCos& GetHeadingSinCos(float heading);
+
+// ---------------------------------------------------------------------------
+// Unit circles
+// ---------------------------------------------------------------------------
+
+constexpr int MinCircleSegments = 8;
+constexpr int MaxCircleSegments = 72;
+
+// Target world units per circle segment ([Map Filters] CircleSegmentLength)
+extern float gMapCircleSegmentLength;
+
+// Segment count for a circle of this radius, within Min/MaxCircleSegments
+int GetCircleSegments(float radius);
+
+// Points of a unit circle split into the given number of segments (clamped
+// to Min/MaxCircleSegments). Point i is at i/segments of a turn, and the
+// first point is repeated at the end so segment i runs from i to i + 1.
+// Built once per segment count and kept for the life of the process.
+const SinCos* GetUnitCircle(int segments);
+
+// ---------------------------------------------------------------------------
+// Marker templates
+// ---------------------------------------------------------------------------
+
+constexpr int MaxMarkerVertices = 8;
+
+struct MarkerTemplate
+{
+	int   VertexCount = 0;
+	bool  Rotates = false;                 // follows the spawn's heading
+	float U[MaxMarkerVertices] = {};       // unit vertex X (east/west)
+	float V[MaxMarkerVertices] = {};       // unit vertex Y (north/south)
+};
+
+const MarkerTemplate& GetMarkerTemplate(MarkerType type);
+
+// Number of lines a marker of this type owns (one per polygon edge)
+int GetMarkerLineCount(MarkerType type);
+
+// Everything needed to place one marker. X/Y are already in map space
+// (negated world coordinates).
+struct MarkerGeometry
+{
+	MarkerType Type = MarkerType::None;
+	float      X = 0.0f;
+	float      Y = 0.0f;
+	float      Z = 0.0f;
+	uint32_t   SideLength = 0;
+	float      Heading = 0.0f;
+	uint32_t   ColorARGB = 0;
+};
+
+// Build a marker into its lines
+void BuildMarker(const MarkerGeometry& geometry, MapViewLine* const* lines);
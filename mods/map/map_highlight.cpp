@@ -0,0 +1,222 @@
+/**
+ * @file map_highlight.cpp
+ * @brief Named highlight sets, each with its own search, color and pulse.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_highlight.h"
+#include "map_object.h"
+
+#include <array>
+#include <bit>
+#include <iterator>
+
+// ---------------------------------------------------------------------------
+// Sets
+// ---------------------------------------------------------------------------
+
+static std::array<HighlightSet, MaxHighlightSets> s_sets;
+static uint32_t s_searchSets = 0;
+
+// Colors handed to new named sets, in turn
+static constexpr MQColor s_palette[] = {
+	MQColor(255, 128, 0),
+	MQColor(0, 200, 255),
+	MQColor(255, 255, 0),
+	MQColor(0, 255, 128),
+	MQColor(255, 64, 160),
+	MQColor(160, 96, 255),
+};
+static size_t s_nextPaletteColor = 0;
+
+const HighlightSet& MapHighlight_GetSet(size_t index)
+{
+	return s_sets[index];
+}
+
+int MapHighlight_FindSet(const char* name)
+{
+	for (size_t i = 0; i < s_sets.size(); i++)
+	{
+		if (s_sets[i].Active && !_stricmp(s_sets[i].Name.c_str(), name))
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+uint32_t MapHighlight_SearchSets()
+{
+	return s_searchSets;
+}
+
+uint32_t MapHighlight_Evaluate(SPAWNINFO* pSpawn, NameID name)
+{
+	uint32_t sets = 0;
+	for (uint32_t remaining = s_searchSets; remaining; remaining &= remaining - 1)
+	{
+		int index = std::countr_zero(remaining);
+		if (s_sets[index].Search.Matches(pSpawn, name))
+			sets |= HighlightSetBit(index);
+	}
+	return sets;
+}
+
+const HighlightSet* MapHighlight_Resolve(uint32_t sets)
+{
+	if (!sets)
+		return nullptr;
+
+	return &s_sets[std::countr_zero(sets)];
+}
+
+// ---------------------------------------------------------------------------
+// Applying changes to map objects
+// ---------------------------------------------------------------------------
+
+// Take a set off every object in it
+static void ClearMembers(size_t index)
+{
+	uint32_t bit = HighlightSetBit(index);
+	MapObjects_ForEach([bit](MapObject* mapObject) {
+		if (mapObject->GetHighlightSets() & bit)
+			mapObject->SetHighlightSets(mapObject->GetHighlightSets() & ~bit);
+	});
+}
+
+// A set's color or pulse changed; its members work out theirs again
+static void ResolveMembers(size_t index)
+{
+	uint32_t bit = HighlightSetBit(index);
+	MapObjects_ForEach([bit](MapObject* mapObject) {
+		if (mapObject->GetHighlightSets() & bit)
+			mapObject->ResolveHighlight();
+	});
+}
+
+int MapHighlight_SetSearch(const char* name, const char* text, int& matched)
+{
+	matched = 0;
+
+	MQSpawnSearch search;
+	ClearSearchSpawn(&search);
+	ParseSearchSpawn(text, &search);
+
+	SpawnSearch compiled(search);
+	if (compiled.IsPositional())
+		return -1;
+
+	// The default set is filled by /highlight <spawnfilter> instead
+	int index = MapHighlight_FindSet(name);
+	if (index == DefaultHighlightSet)
+		return -1;
+
+	if (index < 0)
+	{
+		for (size_t i = DefaultHighlightSet + 1; i < s_sets.size(); i++)
+		{
+			if (!s_sets[i].Active)
+			{
+				index = static_cast<int>(i);
+				break;
+			}
+		}
+		if (index < 0)
+			return -1;
+
+		HighlightSet& set = s_sets[index];
+		set = HighlightSet{};
+		set.Active = true;
+		set.Name = name;
+		set.Color = s_palette[s_nextPaletteColor++ % std::size(s_palette)];
+	}
+	else
+	{
+		ClearMembers(index);
+	}
+
+	HighlightSet& set = s_sets[index];
+	set.Text = text;
+	set.Search = std::move(compiled);
+	s_searchSets |= HighlightSetBit(index);
+
+	for (SPAWNINFO* pSpawn : MapSearch_Find(set.Search))
+	{
+		if (MapObject* mapObject = FindMapObject(pSpawn))
+		{
+			mapObject->SetHighlightSets(mapObject->GetHighlightSets() | HighlightSetBit(index));
+			matched++;
+		}
+	}
+
+	return index;
+}
+
+void MapHighlight_SetColor(size_t index, MQColor color)
+{
+	if (test_and_set(s_sets[index].Color, color))
+		ResolveMembers(index);
+}
+
+void MapHighlight_SetPulse(size_t index, bool pulse)
+{
+	if (test_and_set(s_sets[index].Pulse, pulse))
+		ResolveMembers(index);
+}
+
+void MapHighlight_SetExpiry(size_t index, uint32_t seconds)
+{
+	s_sets[index].ExpiresAt = seconds ? GetTickCount64() + seconds * 1000ull : 0;
+}
+
+void MapHighlight_RemoveSet(size_t index)
+{
+	ClearMembers(index);
+
+	// The default set is always there, it just loses its members
+	if (index == DefaultHighlightSet)
+		return;
+
+	s_sets[index] = HighlightSet{};
+	s_searchSets &= ~HighlightSetBit(index);
+}
+
+void MapHighlight_Reset()
+{
+	MapObjects_ForEach([](MapObject* mapObject) { mapObject->SetHighlightSets(0); });
+
+	for (size_t i = DefaultHighlightSet + 1; i < s_sets.size(); i++)
+		s_sets[i] = HighlightSet{};
+	s_searchSets = 0;
+}
+
+void MapHighlight_DefaultSettingsChanged()
+{
+	HighlightSet& set = s_sets[DefaultHighlightSet];
+	set.Active = true;
+	set.Name = "default";
+
+	bool changed = test_and_set(set.Color, HighlightColor);
+	changed |= test_and_set(set.Pulse, HighlightPulse);
+	if (changed)
+		ResolveMembers(DefaultHighlightSet);
+}
+
+void MapHighlight_Update()
+{
+	uint64_t now = 0;
+	for (size_t i = DefaultHighlightSet + 1; i < s_sets.size(); i++)
+	{
+		HighlightSet& set = s_sets[i];
+		if (!set.Active || !set.ExpiresAt)
+			continue;
+
+		if (!now)
+			now = GetTickCount64();
+		if (now < set.ExpiresAt)
+			continue;
+
+		WriteChatf("Highlight set '%s' expired", set.Name.c_str());
+		MapHighlight_RemoveSet(i);
+	}
+}
@@ -0,0 +1,87 @@
+/**
+ * @file map_highlight.h
+ * @brief Named highlight sets, each with its own search, color and pulse.
+ * @date 2026-10-17
+ *
+ * Up to MaxHighlightSets sets can be active at once. Every map object keeps
+ * a bitmask of the sets it belongs to; when that mask (or a member set's
+ * color or pulse) changes, the object resolves its highlight color and
+ * pulse once, from the lowest-numbered set it is in. Nothing about
+ * highlighting is worked out per frame.
+ *
+ * Set 0 is the plain /highlight set: /highlight <spawnfilter> adds the
+ * spawns matching now, and its color, size and pulse are the existing
+ * [Map Filters] High-Color / HighSize / HighPulse settings.
+ *
+ * Named sets keep their search. Spawns are matched as their objects are
+ * made and when their type, level or name changes, as the show/hide rules are,
+ * so a set follows the zone without rescans. A named set can expire after
+ * a given time. Named sets are not saved.
+ *
+ *   /highlight set <name> <spawnfilter>
+ *   /highlight set <name> color # # # | pulse | expire <seconds>
+ *   /highlight remove <name> | list
+ */
+
+#pragma once
+
+#include "map.h"
+
+#include <cstdint>
+#include <string>
+
+constexpr size_t MaxHighlightSets = 32;
+constexpr uint32_t DefaultHighlightSet = 0;
+
+struct HighlightSet
+{
+	bool        Active = false;
+	std::string Name;
+	std::string Text;           // search as typed; empty for the default set
+	SpawnSearch Search;
+	MQColor     Color;
+	bool        Pulse = false;
+	uint64_t    ExpiresAt = 0;  // GetTickCount64() time, 0 for never
+};
+
+constexpr uint32_t HighlightSetBit(size_t index)
+{
+	return 1u << index;
+}
+
+const HighlightSet& MapHighlight_GetSet(size_t index);
+
+// Index of the active set with this name, or -1
+int MapHighlight_FindSet(const char* name);
+
+// Create or replace a named set and apply it to the map. Returns its index,
+// or -1 if there is no free set or the search depends on position (which
+// can't be kept current without rescanning). matched is how many map
+// objects it highlights.
+int MapHighlight_SetSearch(const char* name, const char* text, int& matched);
+
+void MapHighlight_SetColor(size_t index, MQColor color);
+void MapHighlight_SetPulse(size_t index, bool pulse);
+void MapHighlight_SetExpiry(size_t index, uint32_t seconds);
+
+// Drop a named set, or empty the default set
+void MapHighlight_RemoveSet(size_t index);
+
+// Drop every named set and empty the default set (/highlight reset)
+void MapHighlight_Reset();
+
+// The default set took a color or pulse change from its settings
+void MapHighlight_DefaultSettingsChanged();
+
+// Bits of the named sets whose search the spawn matches. name is the
+// spawn's NameID, if the caller has it.
+uint32_t MapHighlight_Evaluate(SPAWNINFO* pSpawn, NameID name = UnknownName);
+
+// Bits of the sets that follow a search (and so are re-evaluated)
+uint32_t MapHighlight_SearchSets();
+
+// The set an object in these sets takes its color and pulse from, or nullptr
+const HighlightSet* MapHighlight_Resolve(uint32_t sets);
+
+// Expire sets whose time is up. Called from MapUpdate.
+void MapHighlight_Update();
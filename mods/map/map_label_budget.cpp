@@ -0,0 +1,141 @@
+/**
+ * @file map_label_budget.cpp
+ * @brief Caps how many map labels are drawn, by priority.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_label_budget.h"
+#include "map_object.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Settings
+// ---------------------------------------------------------------------------
+
+static int s_budget = 150;
+static int s_abbreviatedBudget = 150;
+static int s_abbreviatedLength = 8;
+static int s_interval = 10;     // frames
+
+void LoadMapLabelBudgetSettings()
+{
+	s_budget = std::max(0, GetPrivateProfileInt("Map Labels", "Budget", s_budget, INIFileName));
+	s_abbreviatedBudget = std::max(0, GetPrivateProfileInt("Map Labels", "AbbreviatedBudget", s_abbreviatedBudget, INIFileName));
+	s_abbreviatedLength = std::max(1, GetPrivateProfileInt("Map Labels", "AbbreviatedLength", s_abbreviatedLength, INIFileName));
+	s_interval = std::max(1, GetPrivateProfileInt("Map Labels", "Interval", s_interval, INIFileName));
+}
+
+int MapLabelBudget_GetAbbreviatedLength()
+{
+	return s_abbreviatedLength;
+}
+
+// ---------------------------------------------------------------------------
+// Selection
+// ---------------------------------------------------------------------------
+
+struct BudgetEntry
+{
+	float      Score;
+	MapObject* Object;
+};
+
+// Highest score first; ties broken by address so a pass is repeatable
+static bool HigherPriority(const BudgetEntry& a, const BudgetEntry& b)
+{
+	if (a.Score != b.Score)
+		return a.Score > b.Score;
+	return a.Object < b.Object;
+}
+
+static std::vector<BudgetEntry> s_entries;
+static int s_framesSincePass = 0;
+
+static int s_fullCount = 0;
+static int s_abbreviatedCount = 0;
+static int s_hiddenCount = 0;
+
+static void ApplyTier(const BudgetEntry* first, const BudgetEntry* last, LabelDetail detail, bool hidden)
+{
+	for (const BudgetEntry* entry = first; entry != last; ++entry)
+	{
+		entry->Object->SetLabelDetail(detail);
+		entry->Object->SetLabelHidden(LabelHide_Budget, hidden);
+	}
+}
+
+void MapLabelBudget_Update(bool force, MapUpdateStats& stats)
+{
+	if (force || ++s_framesSincePass >= s_interval)
+	{
+		s_framesSincePass = 0;
+		s_entries.clear();
+
+		float focusX = 0.0f;
+		float focusY = 0.0f;
+		bool hasFocus = false;
+		if (SPAWNINFO* localPlayer = pLocalPlayer)
+		{
+			focusX = SpawnAccess::GetX(localPlayer);
+			focusY = SpawnAccess::GetY(localPlayer);
+			hasFocus = true;
+		}
+
+		// Closeness is scored over the LOD far distance
+		float range = std::max(1.0f, MapLod_GetProfile().FarDistance);
+
+		MapObjects_ForEach([&](MapObject* mapObject) {
+			// Culled and clustered labels aren't drawn anyway
+			if (!mapObject->HasLabel() || mapObject->IsCulled()
+				|| mapObject->IsLabelHidden(LabelHide_Clustered))
+			{
+				return;
+			}
+
+			float score = mapObject->GetLabelPriority();
+			if (hasFocus)
+			{
+				CVector3 pos = mapObject->GetPosition();
+				float dist = hypotf(pos.X - focusX, pos.Y - focusY);
+				score += LabelPriority_Distance * (1.0f - std::min(dist / range, 1.0f));
+			}
+
+			s_entries.push_back({ score, mapObject });
+		});
+
+		BudgetEntry* first = s_entries.data();
+		BudgetEntry* last = first + s_entries.size();
+
+		if (s_budget == 0)
+		{
+			ApplyTier(first, last, LabelDetail::Full, false);
+			s_fullCount = static_cast<int>(s_entries.size());
+			s_abbreviatedCount = 0;
+			s_hiddenCount = 0;
+		}
+		else
+		{
+			BudgetEntry* fullEnd = first + std::min<size_t>(s_budget, s_entries.size());
+			std::nth_element(first, fullEnd, last, HigherPriority);
+
+			BudgetEntry* abbreviatedEnd = fullEnd + std::min<size_t>(s_abbreviatedBudget, last - fullEnd);
+			std::nth_element(fullEnd, abbreviatedEnd, last, HigherPriority);
+
+			ApplyTier(first, fullEnd, LabelDetail::Full, false);
+			ApplyTier(fullEnd, abbreviatedEnd, LabelDetail::Abbreviated, false);
+			ApplyTier(abbreviatedEnd, last, LabelDetail::Full, true);
+
+			s_fullCount = static_cast<int>(fullEnd - first);
+			s_abbreviatedCount = static_cast<int>(abbreviatedEnd - fullEnd);
+			s_hiddenCount = static_cast<int>(last - abbreviatedEnd);
+		}
+	}
+
+	stats.fullLabels = s_fullCount;
+	stats.abbreviatedLabels = s_abbreviatedCount;
+	stats.budgetHiddenLabels = s_hiddenCount;
+}
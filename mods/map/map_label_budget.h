@@ -0,0 +1,36 @@
+/**
+ * @file map_label_budget.h
+ * @brief Caps how many map labels are drawn, by priority.
+ * @date 2026-10-17
+ *
+ * Every few frames each visible object is scored (target, highlighted,
+ * named, hostile con, other players, plus closeness to the local player).
+ * The top Budget objects get their full label, the next AbbreviatedBudget
+ * get a label cut to AbbreviatedLength characters, and the rest are left
+ * with just their marker. Selection uses nth_element, so a pass is linear
+ * in the number of objects and the label count never exceeds the budget.
+ *
+ * INI ([Map Labels]):
+ *   Budget (0 = unlimited), AbbreviatedBudget, AbbreviatedLength, Interval
+ */
+
+#pragma once
+
+#include "map.h"
+
+// Priority weights. Distance adds up to LabelPriority_Distance.
+constexpr float LabelPriority_Always    = 1.0e6f;
+constexpr float LabelPriority_Target    = 1000.0f;
+constexpr float LabelPriority_Highlight = 400.0f;
+constexpr float LabelPriority_Named     = 200.0f;
+constexpr float LabelPriority_Hostile   = 100.0f;
+constexpr float LabelPriority_Distance  = 100.0f;
+constexpr float LabelPriority_Player    = 50.0f;
+
+void LoadMapLabelBudgetSettings();
+
+// Called at the end of MapObjects_Update, after clustering. Reselects when
+// the interval has elapsed or force is set.
+void MapLabelBudget_Update(bool force, MapUpdateStats& stats);
+
+int MapLabelBudget_GetAbbreviatedLength();
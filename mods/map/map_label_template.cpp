@@ -0,0 +1,90 @@
+/**
+ * @file map_label_template.cpp
+ * @brief Compiled %-templates for map labels and click commands.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_label_template.h"
+
+uint32_t LabelTemplate::GetFieldsForSpec(char spec)
+{
+	switch (spec)
+	{
+	case 'N': return LabelField_Name | LabelField_Type;
+	case 'n': return LabelField_Name;
+	case 'h': return LabelField_HP;
+	case 'i': return LabelField_ID;
+	case 'x':
+	case 'y':
+	case 'z': return LabelField_Position;
+	case 'R': return LabelField_Race;
+	case 'C':
+	case 'c': return LabelField_Class;
+	case 'l': return LabelField_Level;
+	default: return LabelField_None;
+	}
+}
+
+void LabelTemplate::Compile(std::string_view text)
+{
+	m_ops.clear();
+	m_literals.clear();
+	m_dependencies = 0;
+
+	auto appendLiteral = [this](std::string_view run)
+	{
+		if (run.empty())
+			return;
+
+		// Merge with the previous literal run ("%%" splits a run in two)
+		if (!m_ops.empty() && m_ops.back().Spec == 0)
+		{
+			m_ops.back().Length += static_cast<uint32_t>(run.size());
+		}
+		else
+		{
+			Op op;
+			op.Offset = static_cast<uint32_t>(m_literals.size());
+			op.Length = static_cast<uint32_t>(run.size());
+			m_ops.push_back(op);
+		}
+
+		m_literals.append(run);
+	};
+
+	size_t start = 0;
+	for (size_t n = 0; n < text.size(); n++)
+	{
+		if (text[n] != '%')
+			continue;
+
+		appendLiteral(text.substr(start, n - start));
+
+		// A trailing '%' has nothing to substitute; keep it literally
+		if (n + 1 >= text.size())
+		{
+			appendLiteral("%");
+			start = text.size();
+			break;
+		}
+
+		char spec = text[++n];
+		if (spec == '%')
+		{
+			appendLiteral("%");
+		}
+		else
+		{
+			Op op;
+			op.Spec = spec;
+			m_ops.push_back(op);
+			m_dependencies |= GetFieldsForSpec(spec);
+		}
+
+		start = n + 1;
+	}
+
+	if (start < text.size())
+		appendLiteral(text.substr(start));
+}
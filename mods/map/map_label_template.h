@@ -0,0 +1,142 @@
+/**
+ * @file map_label_template.h
+ * @brief Compiled %-templates for map labels and click commands.
+ * @date 2026-10-17
+ *
+ * Naming schemes (/mapnames) and click commands (/mapclick) are compiled
+ * once when they are set into a list of literal runs and %-specifiers.
+ * Formatting then walks the list and writes into a fixed buffer, with
+ * numbers going through std::to_chars.
+ *
+ * Each template records which spawn fields it reads, so a label is only
+ * reformatted when one of those fields actually changed.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Spawn fields a template can depend on
+enum LabelField : uint32_t
+{
+	LabelField_None     = 0,
+	LabelField_Name     = 0x0001,   // %N %n
+	LabelField_Type     = 0x0002,   // %N (adds "'s Corpse")
+	LabelField_HP       = 0x0004,   // %h
+	LabelField_ID       = 0x0008,   // %i
+	LabelField_Position = 0x0010,   // %x %y %z
+	LabelField_Race     = 0x0020,   // %R
+	LabelField_Class    = 0x0040,   // %C %c
+	LabelField_Level    = 0x0080,   // %l
+};
+
+// Bounded writer over a caller-supplied buffer. Output that doesn't fit is
+// dropped, and the buffer is always null terminated.
+class LabelWriter
+{
+public:
+	LabelWriter(char* buffer, size_t size)
+		: m_buffer(buffer)
+		, m_pos(buffer)
+		, m_end(buffer + (size ? size - 1 : 0))
+	{
+		if (size)
+			*m_pos = 0;
+	}
+
+	void Append(char c)
+	{
+		if (m_pos < m_end)
+		{
+			*m_pos++ = c;
+			*m_pos = 0;
+		}
+	}
+
+	void Append(std::string_view text)
+	{
+		size_t count = std::min(text.size(), static_cast<size_t>(m_end - m_pos));
+		text.copy(m_pos, count);
+		m_pos += count;
+		*m_pos = 0;
+	}
+
+	template <typename T>
+	void AppendNumber(T value)
+	{
+		auto result = std::to_chars(m_pos, m_end, value);
+		if (result.ec == std::errc())
+			m_pos = result.ptr;
+		*m_pos = 0;
+	}
+
+	void AppendFixed(float value, int precision)
+	{
+		auto result = std::to_chars(m_pos, m_end, value, std::chars_format::fixed, precision);
+		if (result.ec == std::errc())
+			m_pos = result.ptr;
+		*m_pos = 0;
+	}
+
+	void Clear()
+	{
+		m_pos = m_buffer;
+		*m_pos = 0;
+	}
+
+	std::string_view View() const { return std::string_view(m_buffer, m_pos - m_buffer); }
+
+private:
+	char* m_buffer;
+	char* m_pos;
+	char* m_end;
+};
+
+class LabelTemplate
+{
+public:
+	void Compile(std::string_view text);
+
+	// Spawn fields referenced by this template (LabelField bits)
+	uint32_t GetDependencies() const { return m_dependencies; }
+	bool Empty() const { return m_ops.empty(); }
+
+	// Walk the template, calling handler(spec, writer) for each specifier.
+	// If the handler returns false the specifier is written out as-is.
+	template <typename Handler>
+	void Format(LabelWriter& out, Handler&& handler) const
+	{
+		for (const Op& op : m_ops)
+		{
+			if (op.Spec == 0)
+			{
+				out.Append(std::string_view(m_literals).substr(op.Offset, op.Length));
+			}
+			else if (!handler(op.Spec, out))
+			{
+				out.Append('%');
+				out.Append(op.Spec);
+			}
+		}
+	}
+
+	static uint32_t GetFieldsForSpec(char spec);
+
+private:
+	struct Op
+	{
+		char     Spec = 0;      // 0 for a literal run
+		uint32_t Offset = 0;    // into m_literals
+		uint32_t Length = 0;
+	};
+
+	std::vector<Op> m_ops;
+	std::string     m_literals;
+	uint32_t        m_dependencies = 0;
+};
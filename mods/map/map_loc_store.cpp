@@ -0,0 +1,342 @@
+/**
+ * @file map_loc_store.cpp
+ * @brief Map locs saved per zone, with tag and spatial indexes.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_loc_store.h"
+#include "map_object.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Settings
+// ---------------------------------------------------------------------------
+
+static bool s_persist = true;
+
+void LoadMapLocStoreSettings()
+{
+	s_persist = GetPrivateProfileBool("MapLoc", "Persist", s_persist, INIFileName);
+}
+
+// ---------------------------------------------------------------------------
+// Indexes
+// ---------------------------------------------------------------------------
+
+static std::unordered_map<std::string, MapLocTemplate*> s_tags;
+
+struct GridEntry
+{
+	uint64_t        Cell;
+	MapLocTemplate* MapLoc;
+};
+
+// Sorted by cell, so a cell's locs are one equal_range
+static std::vector<GridEntry> s_grid;
+static constexpr float GridCellSize = 200.0f;
+
+// Largest half-size of any loc's X; a click this far from a cell can hit it
+static float s_maxExtent = 0.0f;
+
+static int32_t CellCoord(float value)
+{
+	return static_cast<int32_t>(floorf(value / GridCellSize));
+}
+
+static uint64_t CellKey(int32_t cellX, int32_t cellY)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+static GridEntry MakeGridEntry(MapLocTemplate* mapLoc)
+{
+	const CVector3& pos = mapLoc->GetPosition();
+	return { CellKey(CellCoord(pos.X), CellCoord(pos.Y)), mapLoc };
+}
+
+static bool CellLess(const GridEntry& a, const GridEntry& b)
+{
+	return a.Cell < b.Cell;
+}
+
+// Locs are added in index order, so the first with a tag keeps it
+static void IndexMapLoc(MapLocTemplate* mapLoc)
+{
+	s_tags.emplace(mapLoc->GetTag(), mapLoc);
+	s_maxExtent = std::max(s_maxExtent, mapLoc->GetParams().lineSize);
+}
+
+static void RebuildIndexes()
+{
+	s_tags.clear();
+	s_grid.clear();
+	s_maxExtent = 0.0f;
+
+	s_grid.reserve(gMapLocTemplates.size());
+	for (const auto& mapLoc : gMapLocTemplates)
+	{
+		IndexMapLoc(mapLoc.get());
+		s_grid.push_back(MakeGridEntry(mapLoc.get()));
+	}
+
+	std::stable_sort(s_grid.begin(), s_grid.end(), CellLess);
+}
+
+MapLocTemplate* MapLocStore_FindByTag(std::string_view tag)
+{
+	auto it = s_tags.find(std::string(tag));
+	return it != s_tags.end() ? it->second : nullptr;
+}
+
+MapLocTemplate* MapLocStore_FindAt(float x, float y)
+{
+	MapLocTemplate* best = nullptr;
+	float bestDistance = 0.0f;
+
+	auto consider = [&](MapLocTemplate* mapLoc) {
+		const CVector3& pos = mapLoc->GetPosition();
+		float extent = mapLoc->GetParams().lineSize;
+		float dX = fabsf(pos.X - x);
+		float dY = fabsf(pos.Y - y);
+		if (dX > extent || dY > extent)
+			return;
+
+		float distance = dX * dX + dY * dY;
+		if (!best || distance < bestDistance)
+		{
+			best = mapLoc;
+			bestDistance = distance;
+		}
+	};
+
+	int32_t minX = CellCoord(x - s_maxExtent);
+	int32_t maxX = CellCoord(x + s_maxExtent);
+	int32_t minY = CellCoord(y - s_maxExtent);
+	int32_t maxY = CellCoord(y + s_maxExtent);
+
+	// Huge locs reach across more cells than there are locs
+	uint64_t cells = static_cast<uint64_t>(maxX - minX + 1) * static_cast<uint64_t>(maxY - minY + 1);
+	if (cells > s_grid.size())
+	{
+		for (const GridEntry& entry : s_grid)
+			consider(entry.MapLoc);
+		return best;
+	}
+
+	for (int32_t cellX = minX; cellX <= maxX; cellX++)
+	{
+		for (int32_t cellY = minY; cellY <= maxY; cellY++)
+		{
+			GridEntry key{ CellKey(cellX, cellY), nullptr };
+			auto range = std::equal_range(s_grid.begin(), s_grid.end(), key, CellLess);
+			for (auto it = range.first; it != range.second; ++it)
+				consider(it->MapLoc);
+		}
+	}
+
+	return best;
+}
+
+// ---------------------------------------------------------------------------
+// Files
+// ---------------------------------------------------------------------------
+
+static std::string s_zone;          // zone whose locs are loaded
+static bool s_loading = false;
+
+static std::string GetStoreDirectory()
+{
+	char path[MAX_PATH] = { 0 };
+	GetModuleFileNameA(nullptr, path, MAX_PATH);
+	char* lastSlash = strrchr(path, '\\');
+	if (lastSlash) *(lastSlash + 1) = '\0';
+	return std::string(path) + "MapLocs\\";
+}
+
+static std::string GetZoneFile(const std::string& zone)
+{
+	return GetStoreDirectory() + zone + ".txt";
+}
+
+// Short names are plain words; anything else isn't used in a path
+static bool IsValidZoneName(const char* zone)
+{
+	if (!zone[0])
+		return false;
+
+	for (const char* c = zone; *c; c++)
+	{
+		if (!isalnum(static_cast<unsigned char>(*c)) && *c != '_')
+			return false;
+	}
+	return true;
+}
+
+// One loc per line: y^x^z^size^width^color^radius^rcolor^defaults^label.
+// The label is last, so it may hold anything but a line break. Floats are
+// written with enough digits to read back exactly, since the tag is worked
+// out again from the position on load.
+static constexpr int FieldCount = 10;
+
+static void SaveZone()
+{
+	if (!s_persist || s_loading || s_zone.empty())
+		return;
+
+	std::string path = GetZoneFile(s_zone);
+	if (gMapLocTemplates.empty())
+	{
+		DeleteFileA(path.c_str());
+		return;
+	}
+
+	CreateDirectoryA(GetStoreDirectory().c_str(), nullptr);
+
+	// Written aside and moved over, so a failed write keeps the old file
+	std::string tempPath = path + ".tmp";
+	FILE* fp = _fsopen(tempPath.c_str(), "wb", _SH_DENYWR);
+	if (!fp)
+	{
+		LogFramework("MapLocStore: could not write %s", tempPath.c_str());
+		return;
+	}
+
+	fputs("# y^x^z^size^width^color^radius^rcolor^defaults^label\n", fp);
+	for (const auto& mapLoc : gMapLocTemplates)
+	{
+		const CVector3& pos = mapLoc->GetPosition();
+		const MapLocParams& params = mapLoc->GetParams();
+		fprintf(fp, "%.9g^%.9g^%.9g^%.9g^%.9g^%08X^%.9g^%08X^%d^%s\n",
+			pos.Y, pos.X, pos.Z, params.lineSize, params.width, params.color.ToARGB(),
+			params.circleRadius, params.circleColor.ToARGB(), mapLoc->IsCreatedFromDefaults() ? 1 : 0,
+			mapLoc->GetLabelText().c_str());
+	}
+
+	bool failed = ferror(fp) != 0;
+	failed |= fclose(fp) != 0;
+
+	if (failed || !MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		LogFramework("MapLocStore: could not save %s", path.c_str());
+		DeleteFileA(tempPath.c_str());
+	}
+}
+
+static bool ParseMapLoc(char* line)
+{
+	char* fields[FieldCount];
+	int count = 0;
+
+	fields[count++] = line;
+	for (char* p = line; count < FieldCount && (p = strchr(p, '^')) != nullptr; )
+	{
+		*p++ = '\0';
+		fields[count++] = p;
+	}
+	if (count < FieldCount)
+		return false;
+
+	CVector3 pos;
+	pos.Y = strtof(fields[0], nullptr);
+	pos.X = strtof(fields[1], nullptr);
+	pos.Z = strtof(fields[2], nullptr);
+
+	bool isCreatedFromDefaults = fields[8][0] == '1';
+	MapLocParams params = gDefaultMapLocParams;
+	if (!isCreatedFromDefaults)
+	{
+		params.lineSize = strtof(fields[3], nullptr);
+		params.width = strtof(fields[4], nullptr);
+		params.color.SetARGB(strtoul(fields[5], nullptr, 16));
+		params.circleRadius = strtof(fields[6], nullptr);
+		params.circleColor.SetARGB(strtoul(fields[7], nullptr, 16));
+	}
+
+	// Same tag as /maploc gives it
+	char tag[MAX_STRING];
+	snprintf(tag, sizeof(tag), "%d,%d,%d",
+		static_cast<int>(pos.Y), static_cast<int>(pos.X), static_cast<int>(pos.Z));
+
+	AddMapLoc(std::make_unique<MapLocTemplate>(params, fields[9], tag, pos, isCreatedFromDefaults));
+	return true;
+}
+
+static void LoadZone()
+{
+	FILE* fp = _fsopen(GetZoneFile(s_zone).c_str(), "rb", _SH_DENYNO);
+	if (!fp)
+		return;
+
+	int loaded = 0;
+	int skipped = 0;
+
+	s_loading = true;
+
+	char line[MAX_STRING] = { 0 };
+	while (fgets(line, MAX_STRING, fp) != nullptr)
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+		if (!line[0] || line[0] == '#')
+			continue;
+
+		if (ParseMapLoc(line))
+			loaded++;
+		else
+			skipped++;
+	}
+
+	s_loading = false;
+	fclose(fp);
+
+	LogFramework("MapLocStore: loaded %d map locs for %s (%d bad lines)", loaded, s_zone.c_str(), skipped);
+}
+
+void MapLocStore_SyncZone()
+{
+	// Without persistence locs stay put across zones, as they always did
+	if (!s_persist)
+		return;
+
+	const char* zone = ZoneAccess::GetShortName();
+	if (!IsValidZoneName(zone) || s_zone == zone)
+		return;
+
+	s_zone = zone;
+
+	// The previous zone's locs are already on disk
+	gMapLocTemplates.clear();
+	LoadZone();
+	RebuildIndexes();
+}
+
+void MapLocStore_OnAdded(MapLocTemplate* mapLoc)
+{
+	if (s_loading)
+		return;
+
+	IndexMapLoc(mapLoc);
+
+	GridEntry entry = MakeGridEntry(mapLoc);
+	s_grid.insert(std::upper_bound(s_grid.begin(), s_grid.end(), entry, CellLess), entry);
+
+	SaveZone();
+}
+
+void MapLocStore_OnChanged()
+{
+	if (s_loading)
+		return;
+
+	RebuildIndexes();
+	SaveZone();
+}
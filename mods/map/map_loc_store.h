@@ -0,0 +1,45 @@
+/**
+ * @file map_loc_store.h
+ * @brief Map locs saved per zone, with tag and spatial indexes.
+ * @date 2026-10-17
+ *
+ * /maploc locations belong to the zone they were placed in. Each zone's
+ * locs are kept in MapLocs\<zone short name>.txt under the game directory,
+ * one loc per line, and rewritten whenever a loc is added or removed. On
+ * zone-in the locs of the previous zone are dropped and the new zone's
+ * file is loaded. A loc made from the defaults is saved as such and picks
+ * up the current defaults when loaded.
+ *
+ * Two indexes are kept over gMapLocTemplates and rebuilt when it changes:
+ * a hash of tags ("y,x,z") for /maploc remove, and a sorted grid of cells
+ * for finding the loc under a map click. Either is one lookup however
+ * many locs a zone has.
+ *
+ * INI ([MapLoc]):
+ *   Persist     save and load locs per zone (default on)
+ */
+
+#pragma once
+
+#include "map.h"
+
+#include <string_view>
+
+class MapLocTemplate;
+
+void LoadMapLocStoreSettings();
+
+// Load the current zone's locs if the zone changed since they were last
+// loaded. Called before map locs are created or edited.
+void MapLocStore_SyncZone();
+
+// gMapLocTemplates changed: bring the indexes up to date and save. Adding
+// one loc can just append it to the indexes.
+void MapLocStore_OnAdded(MapLocTemplate* mapLoc);
+void MapLocStore_OnChanged();
+
+// First loc (by index) with this tag, or nullptr
+MapLocTemplate* MapLocStore_FindByTag(std::string_view tag);
+
+// The loc whose X covers this point, nearest first, or nullptr
+MapLocTemplate* MapLocStore_FindAt(float x, float y);
@@ -0,0 +1,157 @@
+/**
+ * @file map_lod.cpp
+ * @brief Distance-based level of detail for map object updates.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_lod.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// Settings
+// ---------------------------------------------------------------------------
+
+bool gMapLodEnabled = true;
+
+static float s_mediumZoneExtent = 4000.0f;
+static float s_largeZoneExtent = 10000.0f;
+
+static const char* s_zoneSizeNames[] = { "Small", "Medium", "Large" };
+
+static MapLodProfile s_profiles[static_cast<int>(MapZoneSize::Count)] = {
+	// Near    Far      Mid  Far interval
+	{  400.0f, 1200.0f, 2,    8 },  // Small
+	{  600.0f, 2000.0f, 3,   12 },  // Medium
+	{  800.0f, 3000.0f, 4,   16 },  // Large
+};
+
+static MapZoneSize s_zoneSize = MapZoneSize::Medium;
+
+void LoadMapLodSettings()
+{
+	gMapLodEnabled = GetPrivateProfileBool("Map LOD", "Enabled", gMapLodEnabled, INIFileName);
+	s_mediumZoneExtent = GetPrivateProfileFloat("Map LOD", "MediumZoneExtent", s_mediumZoneExtent, INIFileName);
+	s_largeZoneExtent = GetPrivateProfileFloat("Map LOD", "LargeZoneExtent", s_largeZoneExtent, INIFileName);
+
+	for (int i = 0; i < static_cast<int>(MapZoneSize::Count); i++)
+	{
+		MapLodProfile& profile = s_profiles[i];
+		char key[64];
+
+		snprintf(key, sizeof(key), "%s-Near", s_zoneSizeNames[i]);
+		profile.NearDistance = GetPrivateProfileFloat("Map LOD", key, profile.NearDistance, INIFileName);
+
+		snprintf(key, sizeof(key), "%s-Far", s_zoneSizeNames[i]);
+		profile.FarDistance = GetPrivateProfileFloat("Map LOD", key, profile.FarDistance, INIFileName);
+
+		snprintf(key, sizeof(key), "%s-MidInterval", s_zoneSizeNames[i]);
+		profile.MidInterval = std::max(1, GetPrivateProfileInt("Map LOD", key, profile.MidInterval, INIFileName));
+
+		snprintf(key, sizeof(key), "%s-FarInterval", s_zoneSizeNames[i]);
+		profile.FarInterval = std::max(1, GetPrivateProfileInt("Map LOD", key, profile.FarInterval, INIFileName));
+
+		if (profile.FarDistance < profile.NearDistance)
+			profile.FarDistance = profile.NearDistance;
+	}
+}
+
+void MapLod_SetZoneExtent(float extent)
+{
+	if (extent >= s_largeZoneExtent)
+		s_zoneSize = MapZoneSize::Large;
+	else if (extent >= s_mediumZoneExtent)
+		s_zoneSize = MapZoneSize::Medium;
+	else
+		s_zoneSize = MapZoneSize::Small;
+
+	LogFramework("MapLod: zone extent %.0f -> %s profile", extent,
+		s_zoneSizeNames[static_cast<int>(s_zoneSize)]);
+}
+
+MapZoneSize MapLod_GetZoneSize()
+{
+	return s_zoneSize;
+}
+
+const MapLodProfile& MapLod_GetProfile()
+{
+	return s_profiles[static_cast<int>(s_zoneSize)];
+}
+
+// ---------------------------------------------------------------------------
+// Per-frame classification
+// ---------------------------------------------------------------------------
+
+// Detail is centred on the local player and the current target
+static constexpr int MaxFocusPoints = 2;
+static float s_focusX[MaxFocusPoints];
+static float s_focusY[MaxFocusPoints];
+static int s_focusCount = 0;
+
+static float s_nearDistSq = 0.0f;
+static float s_farDistSq = 0.0f;
+static uint32_t s_frame = 0;
+
+void MapLod_BeginFrame()
+{
+	++s_frame;
+	s_focusCount = 0;
+
+	if (SPAWNINFO* localPlayer = pLocalPlayer)
+	{
+		s_focusX[s_focusCount] = SpawnAccess::GetX(localPlayer);
+		s_focusY[s_focusCount] = SpawnAccess::GetY(localPlayer);
+		s_focusCount++;
+	}
+
+	if (SPAWNINFO* target = pTarget)
+	{
+		s_focusX[s_focusCount] = SpawnAccess::GetX(target);
+		s_focusY[s_focusCount] = SpawnAccess::GetY(target);
+		s_focusCount++;
+	}
+
+	const MapLodProfile& profile = MapLod_GetProfile();
+	s_nearDistSq = profile.NearDistance * profile.NearDistance;
+	s_farDistSq = profile.FarDistance * profile.FarDistance;
+}
+
+MapLodTier MapLod_Classify(const CVector3& pos)
+{
+	// Without a focus point there's nothing to measure against
+	if (s_focusCount == 0)
+		return MapLodTier::Near;
+
+	float bestDistSq = FLT_MAX;
+	for (int i = 0; i < s_focusCount; i++)
+	{
+		float dx = pos.X - s_focusX[i];
+		float dy = pos.Y - s_focusY[i];
+		bestDistSq = std::min(bestDistSq, dx * dx + dy * dy);
+	}
+
+	if (bestDistSq <= s_nearDistSq)
+		return MapLodTier::Near;
+	if (bestDistSq <= s_farDistSq)
+		return MapLodTier::Mid;
+	return MapLodTier::Far;
+}
+
+bool MapLod_IsDue(MapLodTier tier, uint32_t cohort)
+{
+	const MapLodProfile& profile = MapLod_GetProfile();
+
+	switch (tier)
+	{
+	case MapLodTier::Mid:
+		return (s_frame + cohort) % static_cast<uint32_t>(profile.MidInterval) == 0;
+	case MapLodTier::Far:
+		return (s_frame + cohort) % static_cast<uint32_t>(profile.FarInterval) == 0;
+	default:
+		return true;
+	}
+}
@@ -0,0 +1,62 @@
+/**
+ * @file map_lod.h
+ * @brief Distance-based level of detail for map object updates.
+ * @date 2026-10-17
+ *
+ * Map objects are sorted into tiers by their distance to the local player
+ * and the current target. Near objects refresh every frame, mid-range ones
+ * every MidInterval frames, and far ones only move their label and marker
+ * every FarInterval frames. Each object belongs to a round-robin cohort so
+ * the deferred work is spread evenly over the interval instead of landing
+ * on one frame.
+ *
+ * Thresholds and rates come from one of three profiles picked by the
+ * zone's size, measured from the spawn bounding box at MapGenerate.
+ *
+ * INI ([Map LOD]):
+ *   Enabled, MediumZoneExtent, LargeZoneExtent,
+ *   <Small|Medium|Large>-Near, -Far, -MidInterval, -FarInterval
+ */
+
+#pragma once
+
+#include "map.h"
+
+enum class MapLodTier : uint8_t
+{
+	Near,
+	Mid,
+	Far,
+};
+
+enum class MapZoneSize
+{
+	Small,
+	Medium,
+	Large,
+
+	Count,
+};
+
+struct MapLodProfile
+{
+	float NearDistance;
+	float FarDistance;
+	int   MidInterval;
+	int   FarInterval;
+};
+
+extern bool gMapLodEnabled;
+
+void LoadMapLodSettings();
+
+// Pick the active profile from the extent (largest X/Y span) of the zone
+void MapLod_SetZoneExtent(float extent);
+MapZoneSize MapLod_GetZoneSize();
+const MapLodProfile& MapLod_GetProfile();
+
+// Called once per MapUpdate before any objects are classified
+void MapLod_BeginFrame();
+
+MapLodTier MapLod_Classify(const CVector3& pos);
+bool MapLod_IsDue(MapLodTier tier, uint32_t cohort);
@@ -7,6 +7,9 @@
  *   1. Run MapUpdate (position/color updates)
  *   2. Splice our label/line lists into the game's map for rendering
  *
+ * HandleMouseMove and HandleWheelMove feed the screen/world point pairs
+ * that map_view.cpp measures the map's view transform from.
+ *
  * PostDraw is MapViewMap-specific (only MapViewMap overrides it), so no
  * thisPtr filtering is needed. The base-class Draw (slot 3) renders generic
  * window chrome, NOT map content — label rendering happens in PostDraw.
@@ -18,6 +21,7 @@
 #include "map_mod.h"
 #include "map.h"
 #include "map_object.h"
+#include "map_view.h"
 #include "../../hooks.h"
 
 #include <eqlib/Offsets.h>
@@ -33,10 +37,14 @@ extern "C" uintptr_t EQGameBaseAddress;
 using PostDraw_t = int(__fastcall*)(void* thisPtr, void* edx);
 using HandleLButtonDown_t = int(__fastcall*)(void* thisPtr, void* edx, const CXPoint& pos, uint32_t flags);
 using HandleRButtonDown_t = int(__fastcall*)(void* thisPtr, void* edx, const CXPoint& pos, uint32_t flags);
+using HandleMouseMove_t = int(__fastcall*)(void* thisPtr, void* edx, const CXPoint& pos, uint32_t flags);
+using HandleWheelMove_t = int(__fastcall*)(void* thisPtr, void* edx, const CXPoint& pos, int scroll, uint32_t flags);
 
 static PostDraw_t PostDraw_Original = nullptr;
 static HandleLButtonDown_t HandleLButtonDown_Original = nullptr;
 static HandleRButtonDown_t HandleRButtonDown_Original = nullptr;
+static HandleMouseMove_t HandleMouseMove_Original = nullptr;
+static HandleWheelMove_t HandleWheelMove_Original = nullptr;
 
 // ---------------------------------------------------------------------------
 // PostDraw hook — MapUpdate + label/line splice for rendering
@@ -139,7 +147,7 @@ static int __fastcall PostDraw_Detour(void* thisPtr, void* edx)
 			SPAWNINFO* localPlayer = pLocalPlayer;
 			if (!localPlayer)
 			{
-				if (gpActiveMapObjects || gpLabelList || gpLineList)
+				if (MapObjects_Count() != 0 || gpLabelList || gpLineList)
 				{
 					LogFramework("PostDraw: pLocalPlayer null at frame %d — zone transition, clearing map",
 						s_postDrawFrameCount);
@@ -157,7 +165,7 @@ static int __fastcall PostDraw_Detour(void* thisPtr, void* edx)
 				MapClear();  // clear any objects added by OnAddSpawn during transition
 				MapGenerate();
 				s_needsRegenerate = false;
-				s_hadMapObjects = (gpActiveMapObjects != nullptr);
+				s_hadMapObjects = (MapObjects_Count() != 0);
 				s_firstRenderLogged = false;
 			}
 
@@ -165,7 +173,7 @@ static int __fastcall PostDraw_Detour(void* thisPtr, void* edx)
 			// one-by-one via PrepForDestroyPlayer BEFORE pLocalPlayer goes null.
 			// In that case the null-player check above never fires. Detect
 			// populated→empty transition and schedule a full regenerate.
-			if (gpActiveMapObjects)
+			if (MapObjects_Count() != 0)
 			{
 				s_hadMapObjects = true;
 			}
@@ -244,6 +252,41 @@ static int __fastcall HandleRButtonDown_Detour(void* thisPtr, void* edx, const C
 	return HandleRButtonDown_Original(thisPtr, edx, pos, flags);
 }
 
+// ---------------------------------------------------------------------------
+// HandleMouseMove / HandleWheelMove hooks — view measurement for culling
+// ---------------------------------------------------------------------------
+
+// Both may be inherited from CXWnd, so only our MapViewMap is sampled. The
+// game handles the event first, so GetWorldCoordinates sees this point.
+static void SampleMapView(void* thisPtr, const CXPoint& pos, bool zoomed)
+{
+	if (thisPtr != GetMapViewMapPtr() || !s_mapRenderEnabled)
+		return;
+
+	__try
+	{
+		MapView_OnMouseEvent(thisPtr, pos, zoomed);
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		LogFramework("!!! MapView sample EXCEPTION code=0x%08X", GetExceptionCode());
+	}
+}
+
+static int __fastcall HandleMouseMove_Detour(void* thisPtr, void* edx, const CXPoint& pos, uint32_t flags)
+{
+	int result = HandleMouseMove_Original(thisPtr, edx, pos, flags);
+	SampleMapView(thisPtr, pos, false);
+	return result;
+}
+
+static int __fastcall HandleWheelMove_Detour(void* thisPtr, void* edx, const CXPoint& pos, int scroll, uint32_t flags)
+{
+	int result = HandleWheelMove_Original(thisPtr, edx, pos, scroll, flags);
+	SampleMapView(thisPtr, pos, true);
+	return result;
+}
+
 // ---------------------------------------------------------------------------
 // MapMod implementation
 // ---------------------------------------------------------------------------
@@ -287,6 +330,24 @@ bool MapMod::Initialize()
 		reinterpret_cast<void**>(&HandleRButtonDown_Original),
 		reinterpret_cast<void*>(&HandleRButtonDown_Detour));
 
+	// HandleMouseMove and HandleWheelMove are vtable slots 24 and 25 (offsets
+	// 0x60 and 0x64), after the wheel button handlers. Also guarded by thisPtr.
+	uintptr_t mouseMoveAddr = *reinterpret_cast<uintptr_t*>(vtableAddr + 0x60);
+	HandleMouseMove_Original = reinterpret_cast<HandleMouseMove_t>(mouseMoveAddr);
+	LogFramework("  HandleMouseMove function = 0x%08X", static_cast<unsigned int>(mouseMoveAddr));
+
+	Hooks::Install("MapViewMap_HandleMouseMove",
+		reinterpret_cast<void**>(&HandleMouseMove_Original),
+		reinterpret_cast<void*>(&HandleMouseMove_Detour));
+
+	uintptr_t wheelMoveAddr = *reinterpret_cast<uintptr_t*>(vtableAddr + 0x64);
+	HandleWheelMove_Original = reinterpret_cast<HandleWheelMove_t>(wheelMoveAddr);
+	LogFramework("  HandleWheelMove function = 0x%08X", static_cast<unsigned int>(wheelMoveAddr));
+
+	Hooks::Install("MapViewMap_HandleWheelMove",
+		reinterpret_cast<void**>(&HandleWheelMove_Original),
+		reinterpret_cast<void*>(&HandleWheelMove_Detour));
+
 	// Initialize map state (clears all circles)
 	MapInit();
 
@@ -347,8 +408,9 @@ void MapMod::Shutdown()
 void MapMod::OnPulse()
 {
 	// MapUpdate is called from PostDraw detour, not OnPulse.
-	// But highlight pulse animation runs here on a timer.
-	if (HighlightPulse)
+	// But highlight pulse animation runs here on a timer, while anything
+	// on the map is pulsing.
+	if (MapObjects_HasPulsing())
 	{
 		static clock_t s_lastPulse = clock();
 		clock_t now = clock();
@@ -374,14 +436,25 @@ bool MapMod::OnIncomingMessage(uint32_t /*opcode*/, const void* /*buffer*/, uint
 
 void MapMod::OnAddSpawn(void* pSpawn)
 {
+	// The classification cache tracks spawns even while the map is off
+	SpawnClass_OnCreate(static_cast<SPAWNINFO*>(pSpawn));
+
 	if (m_mapActive)
+	{
 		AddSpawn(static_cast<SPAWNINFO*>(pSpawn));
+		MapSearch_OnSpawnAdded(static_cast<SPAWNINFO*>(pSpawn));
+	}
 }
 
 void MapMod::OnRemoveSpawn(void* pSpawn)
 {
 	if (m_mapActive)
+	{
 		RemoveSpawn(static_cast<SPAWNINFO*>(pSpawn));
+		MapSearch_OnSpawnRemoved(static_cast<SPAWNINFO*>(pSpawn));
+	}
+
+	SpawnClass_OnDestroy(static_cast<SPAWNINFO*>(pSpawn));
 }
 
 void MapMod::OnAddGroundItem(void* pItem)
@@ -407,7 +480,7 @@ void MapMod::OnSetGameState(int gameState)
 		s_mapRenderEnabled = true;
 		s_postDrawFaultCooldown = 0;
 		s_needsRegenerate = false;
-		s_hadMapObjects = (gpActiveMapObjects != nullptr);
+		s_hadMapObjects = (MapObjects_Count() != 0);
 		s_firstRenderLogged = false;
 	}
 	else
@@ -433,9 +506,17 @@ void MapMod::OnReloadUI()
 {
 	if (GameState::GetGameState() == GAMESTATE_INGAME)
 	{
-		LogFramework("MapMod::OnReloadUI — regenerating map");
-		MapClear();
-		MapGenerate();
+		// Spawns survive a UI reload, so the existing objects are kept
+		LogFramework("MapMod::OnReloadUI — reconciling map");
+		if (m_mapActive)
+		{
+			MapReconcile();
+		}
+		else
+		{
+			MapClear();
+			MapGenerate();
+		}
 		m_mapActive = true;
 		s_mapRenderEnabled = true;
 	}
@@ -0,0 +1,119 @@
+/**
+ * @file map_motion.cpp
+ * @brief Smooth spawn movement between position updates.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_motion.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ---------------------------------------------------------------------------
+// Settings
+// ---------------------------------------------------------------------------
+
+bool gMapMotionEnabled = true;
+
+static float s_maxExtrapolation = 0.6f;
+static float s_settleTime = 0.3f;
+static float s_correctionTime = 0.25f;
+static float s_maxSampleGap = 2.0f;
+static float s_snapDistance = 100.0f;
+
+void LoadMapMotionSettings()
+{
+	gMapMotionEnabled = GetPrivateProfileBool("Map Motion", "Enabled", gMapMotionEnabled, INIFileName);
+	s_maxExtrapolation = std::max(0.0f, GetPrivateProfileFloat("Map Motion", "MaxExtrapolation", s_maxExtrapolation, INIFileName));
+	s_settleTime = std::max(0.01f, GetPrivateProfileFloat("Map Motion", "SettleTime", s_settleTime, INIFileName));
+	s_correctionTime = std::max(0.01f, GetPrivateProfileFloat("Map Motion", "CorrectionTime", s_correctionTime, INIFileName));
+	s_maxSampleGap = std::max(0.01f, GetPrivateProfileFloat("Map Motion", "MaxSampleGap", s_maxSampleGap, INIFileName));
+	s_snapDistance = std::max(0.0f, GetPrivateProfileFloat("Map Motion", "SnapDistance", s_snapDistance, INIFileName));
+}
+
+// ---------------------------------------------------------------------------
+// Frame time
+// ---------------------------------------------------------------------------
+
+static double s_frameTime = 0.0;
+
+void MapMotion_BeginFrame()
+{
+	static const auto s_start = std::chrono::steady_clock::now();
+	s_frameTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - s_start).count();
+}
+
+// ---------------------------------------------------------------------------
+// MotionTrack
+// ---------------------------------------------------------------------------
+
+static float DistanceSquared(const CVector3& a, const CVector3& b)
+{
+	float dX = a.X - b.X;
+	float dY = a.Y - b.Y;
+	float dZ = a.Z - b.Z;
+	return dX * dX + dY * dY + dZ * dZ;
+}
+
+double MotionTrack::ExtrapolationHorizon() const
+{
+	return std::min(static_cast<double>(s_maxExtrapolation), m_interval * 1.5);
+}
+
+bool MotionTrack::Sample(const CVector3& pos)
+{
+	if (m_valid && pos == m_position)
+		return false;
+
+	double elapsed = s_frameTime - m_time;
+	float snap = s_snapDistance * s_snapDistance;
+
+	if (!m_valid || elapsed <= 0.0 || elapsed > s_maxSampleGap || DistanceSquared(pos, m_position) > snap)
+	{
+		m_velocity = CVector3{};
+		m_correction = CVector3{};
+		m_interval = 0.0;
+	}
+	else
+	{
+		CVector3 shown = Predict();
+		float scale = static_cast<float>(1.0 / elapsed);
+
+		m_velocity = CVector3{ (pos.X - m_position.X) * scale, (pos.Y - m_position.Y) * scale, (pos.Z - m_position.Z) * scale };
+		m_correction = CVector3{ shown.X - pos.X, shown.Y - pos.Y, shown.Z - pos.Z };
+		m_interval = elapsed;
+
+		if (DistanceSquared(shown, pos) > snap)
+			m_correction = CVector3{};
+	}
+
+	m_position = pos;
+	m_time = s_frameTime;
+	m_valid = true;
+	return true;
+}
+
+CVector3 MotionTrack::Predict() const
+{
+	double age = s_frameTime - m_time;
+	double horizon = ExtrapolationHorizon();
+
+	// Carry on at the last velocity up to the horizon, then ease back
+	double travel = age <= horizon ? age
+		: horizon * std::max(0.0, 1.0 - (age - horizon) / s_settleTime);
+	float fade = static_cast<float>(std::max(0.0, 1.0 - age / s_correctionTime));
+	float t = static_cast<float>(travel);
+
+	return CVector3{
+		m_position.X + m_velocity.X * t + m_correction.X * fade,
+		m_position.Y + m_velocity.Y * t + m_correction.Y * fade,
+		m_position.Z + m_velocity.Z * t + m_correction.Z * fade,
+	};
+}
+
+bool MotionTrack::IsSettled() const
+{
+	double age = s_frameTime - m_time;
+	return age >= ExtrapolationHorizon() + s_settleTime && age >= s_correctionTime;
+}
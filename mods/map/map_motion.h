@@ -0,0 +1,66 @@
+/**
+ * @file map_motion.h
+ * @brief Smooth spawn movement between position updates.
+ * @date 2026-10-17
+ *
+ * A spawn's position in client memory only changes when a movement update
+ * arrives, so a marker read straight from it sits still and then jumps,
+ * however often the map refreshes. A MotionTrack keeps the last position
+ * read, when it was read and the velocity from the one before, and
+ * predicts where the spawn is now:
+ *
+ *   - Up to about one and a half update intervals (at most
+ *     MaxExtrapolation) after a new position, the marker carries on at
+ *     the last velocity. If no update follows, the spawn has most likely
+ *     stopped, and over SettleTime the marker eases back onto the last
+ *     position read.
+ *   - When a new position arrives, the gap between it and the prediction
+ *     fades out over CorrectionTime instead of showing as a jump.
+ *   - A move longer than SnapDistance in one update (a gate, a summon) or
+ *     after MaxSampleGap without one is taken as is, with no velocity.
+ *
+ * Predictions only use the frame time, so moving markers along between
+ * updates costs no spawn memory reads; see MapObjectSpawn::MoveTracked.
+ *
+ * INI ([Map Motion]):
+ *   Enabled, MaxExtrapolation, SettleTime, CorrectionTime (seconds),
+ *   MaxSampleGap (seconds), SnapDistance
+ */
+
+#pragma once
+
+#include "map.h"
+
+extern bool gMapMotionEnabled;
+
+void LoadMapMotionSettings();
+
+// Called once per MapUpdate, before any track is sampled or predicted
+void MapMotion_BeginFrame();
+
+class MotionTrack
+{
+public:
+	// Feed the position read from the spawn this frame. Returns false if it
+	// hasn't changed since the last one.
+	bool Sample(const CVector3& pos);
+
+	// Where the spawn is shown this frame
+	CVector3 Predict() const;
+
+	// True once the prediction has come to rest on the last position read
+	bool IsSettled() const;
+
+	bool IsValid() const { return m_valid; }
+	const CVector3& GetLastSample() const { return m_position; }
+
+private:
+	double ExtrapolationHorizon() const;
+
+	CVector3 m_position;            // last position read
+	CVector3 m_velocity;            // per second
+	CVector3 m_correction;          // shown minus read when it was read
+	double   m_time = 0.0;          // frame time of the last position
+	double   m_interval = 0.0;      // time between the last two positions
+	bool     m_valid = false;
+};
@@ -0,0 +1,127 @@
+/**
+ * @file map_names.cpp
+ * @brief Spawn names interned once per zone, with their lowered forms.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_names.h"
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// The spawn's name buffers are 0x40 bytes; never read past them
+static constexpr size_t MaxNameLength = 0x40;
+
+// Entries by NameID. Entry 0 is NoName.
+static std::vector<InternedName> s_names(1);
+
+// Open-addressing table of IDs, probed linearly. NoName marks a free slot.
+static std::vector<NameID> s_slots;
+static size_t s_mask = 0;
+static uint32_t s_generation = 0;      // bumped by MapNames_Clear
+
+static uint64_t HashNames(std::string_view name, std::string_view displayed)
+{
+	// FNV-1a over both strings, with a separator so ("ab", "c") and
+	// ("a", "bc") differ
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : name)
+		hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+	hash = (hash ^ 0xff) * 1099511628211ull;
+	for (char c : displayed)
+		hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+	return hash;
+}
+
+static std::string Lowered(std::string_view text)
+{
+	std::string lowered(text);
+	for (char& c : lowered)
+		c = LowerAscii(c);
+	return lowered;
+}
+
+static void Rehash(size_t capacity)
+{
+	s_slots.assign(capacity, NoName);
+	s_mask = capacity - 1;
+
+	for (NameID id = 1; id < s_names.size(); id++)
+	{
+		size_t i = s_names[id].Hash & s_mask;
+		while (s_slots[i] != NoName)
+			i = (i + 1) & s_mask;
+		s_slots[i] = id;
+	}
+}
+
+NameID MapNames_Intern(const char* name, const char* displayed)
+{
+	std::string_view nameView(name, strnlen(name, MaxNameLength));
+	std::string_view displayedView(displayed, strnlen(displayed, MaxNameLength));
+	if (nameView.empty() && displayedView.empty())
+		return NoName;
+
+	// Kept under three quarters full
+	if ((s_names.size() + 1) * 4 > s_slots.size() * 3)
+		Rehash(s_slots.empty() ? 256 : s_slots.size() * 2);
+
+	uint64_t hash = HashNames(nameView, displayedView);
+
+	size_t i = hash & s_mask;
+	for (; s_slots[i] != NoName; i = (i + 1) & s_mask)
+	{
+		const InternedName& entry = s_names[s_slots[i]];
+		if (entry.Hash == hash && entry.Name == nameView && entry.Displayed == displayedView)
+			return s_slots[i];
+	}
+
+	NameID id = static_cast<NameID>(s_names.size());
+	InternedName& entry = s_names.emplace_back();
+	entry.Name = nameView;
+	entry.Displayed = displayedView;
+	entry.LowerName = Lowered(nameView);
+	entry.LowerDisplayed = Lowered(displayedView);
+	entry.Hash = hash;
+
+	s_slots[i] = id;
+	return id;
+}
+
+NameID MapNames_Intern(SPAWNINFO* pSpawn)
+{
+	return MapNames_Intern(SpawnAccess::GetName(pSpawn), SpawnAccess::GetDisplayedName(pSpawn));
+}
+
+const InternedName& MapNames_Get(NameID id)
+{
+	return id < s_names.size() ? s_names[id] : s_names[NoName];
+}
+
+bool MapNames_IsIncomplete(NameID id)
+{
+	const InternedName& entry = MapNames_Get(id);
+	return entry.Name.empty() || entry.Displayed.empty();
+}
+
+size_t MapNames_Count()
+{
+	return s_names.size() - 1;
+}
+
+uint32_t MapNames_GetGeneration()
+{
+	return s_generation;
+}
+
+void MapNames_Clear()
+{
+	s_names.resize(1);
+	s_names.shrink_to_fit();
+	s_slots.clear();
+	s_slots.shrink_to_fit();
+	s_mask = 0;
+	++s_generation;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file map_names.h
+ * @brief Spawn names interned once per zone, with their lowered forms.
+ * @date 2026-10-17
+ *
+ * Every map pass used to go back to the spawn's name buffers: labels copy
+ * the displayed name, searches fold both names to lower case a character at
+ * a time on every call, and the rule name scans were cached per name
+ * pointer. MapNames_Intern stores each distinct (name, displayed name) pair
+ * once, with the lowered forms worked out up front, and hands back a 32-bit
+ * NameID. Two spawns with the same ID have the same names, so name
+ * comparisons are integer compares and anything derived from a name can be
+ * cached per ID.
+ *
+ * Entries are found by a hash of both strings in a flat open-addressing
+ * table. The table lives until MapClear; IDs must not be kept past it.
+ */
+
+#pragma once
+
+#include "../../mq_compat.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+using NameID = uint32_t;
+
+// The ID of a spawn whose names haven't been filled in yet
+constexpr NameID NoName = 0;
+
+// Passed for a spawn's ID by callers that haven't interned its names; the
+// callee interns them if it needs them
+constexpr NameID UnknownName = UINT32_MAX;
+
+struct InternedName
+{
+	std::string Name;               // as in the spawn ("a_rat01")
+	std::string Displayed;          // the client's display form ("a rat")
+	std::string LowerName;
+	std::string LowerDisplayed;
+	uint64_t    Hash = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Case folding (ASCII only, as the client's names are)
+// ---------------------------------------------------------------------------
+
+constexpr std::array<char, 256> MakeLowerTable()
+{
+	std::array<char, 256> table = {};
+	for (int i = 0; i < 256; i++)
+		table[i] = static_cast<char>(i >= 'A' && i <= 'Z' ? i - 'A' + 'a' : i);
+	return table;
+}
+
+inline constexpr std::array<char, 256> LowerTable = MakeLowerTable();
+
+inline char LowerAscii(char c)
+{
+	return LowerTable[static_cast<unsigned char>(c)];
+}
+
+// ---------------------------------------------------------------------------
+// Interning
+// ---------------------------------------------------------------------------
+
+NameID MapNames_Intern(const char* name, const char* displayed);
+NameID MapNames_Intern(SPAWNINFO* pSpawn);
+
+// NoName gives an entry with empty strings
+const InternedName& MapNames_Get(NameID id);
+
+// True if either of the ID's names is still empty (the spawn was read
+// during zone loading); worth interning again later
+bool MapNames_IsIncomplete(NameID id);
+
+size_t MapNames_Count();
+
+// Changes each time the names are cleared, so a cache indexed by NameID
+// can tell that its IDs no longer mean anything
+uint32_t MapNames_GetGeneration();
+
+// Forget every name. Called from MapClear, once no object holds an ID.
+void MapNames_Clear();
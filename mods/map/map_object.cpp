@@ -13,13 +13,22 @@
 
 #include "pch.h"
 #include "map_object.h"
+#include "map_view.h"
+#include "map_cluster.h"
+#include "map_highlight.h"
+#include "map_label_budget.h"
+#include "map_loc_store.h"
+#include "pointer_map.h"
+#include "slot_map.h"
+
+#include <algorithm>
+#include <deque>
 
 // ---------------------------------------------------------------------------
 // Global state definitions (from both MapObject.cpp and MQ2Map.cpp)
 // ---------------------------------------------------------------------------
 
 extern MapObject* pLastTarget;
-MapObject* gpActiveMapObjects = nullptr;
 
 std::vector<std::unique_ptr<MapLocTemplate>> gMapLocTemplates;
 MapLocParams gDefaultMapLocParams;
@@ -150,6 +159,79 @@ std::vector<MapFilterOption> MapFilterOptions = {
 	  "Sets radius of pull circle" },
 };
 
+// ---------------------------------------------------------------------------
+// Effective filter states — rebuilt whenever an option is toggled, so
+// visibility checks are a mask test instead of a walk up RequiresOption
+// ---------------------------------------------------------------------------
+
+MapFilterMask gMapFilterEffective = 0;
+
+// Filter that controls each spawn type. Invalid means always shown; NPC
+// (named) and corpse (PC/NPC) need the spawn and are resolved separately.
+static constexpr MapFilter GetSpawnTypeFilter(eSpawnType type)
+{
+	switch (type)
+	{
+	case PC: return MapFilter::PC;
+	case NPC: return MapFilter::NPC;
+	case ITEM: return MapFilter::Ground;
+	case UNTARGETABLE: return MapFilter::Untargetable;
+	case TIMER: return MapFilter::Timer;
+	case TRAP: return MapFilter::Trap;
+	case TRIGGER: return MapFilter::Trigger;
+	case CHEST: return MapFilter::Chest;
+	case PET: return MapFilter::Pet;
+	case MOUNT: return MapFilter::Mount;
+	case AURA: return MapFilter::Aura;
+	case OBJECT: return MapFilter::Object;
+	case BANNER: return MapFilter::Banner;
+	case CAMPFIRE: return MapFilter::Campfire;
+	case MERCENARY: return MapFilter::Mercenary;
+	default: return MapFilter::Invalid;
+	}
+}
+
+static constexpr size_t SpawnTypeTableSize = static_cast<size_t>(FLYER) + 1;
+static bool s_spawnTypeVisible[SpawnTypeTableSize];
+
+void MapFilters_Recompute()
+{
+	static bool s_checkedParents = false;
+	if (!s_checkedParents)
+	{
+		s_checkedParents = true;
+		for (size_t i = 0; i < MapFilterOptions.size() && i < std::size(MapFilterParents); i++)
+		{
+			if (MapFilterOptions[i].RequiresOption != MapFilterParents[i])
+				LogFramework("MapFilters: '%s' requires %d but MapFilterParents has %d", MapFilterOptions[i].szName,
+					static_cast<int>(MapFilterOptions[i].RequiresOption), static_cast<int>(MapFilterParents[i]));
+		}
+	}
+
+	MapFilterMask enabled = 0;
+	for (const MapFilterOption& option : MapFilterOptions)
+	{
+		if (option.Enabled)
+			enabled |= MapFilterBit(option.ThisFilter);
+	}
+
+	MapFilterMask effective = 0;
+	for (size_t i = 0; i < MapFilterClosure.size(); i++)
+	{
+		if ((enabled & MapFilterClosure[i]) == MapFilterClosure[i])
+			effective |= MapFilterBit(static_cast<MapFilter>(i));
+	}
+
+	gMapFilterEffective = effective;
+
+	for (size_t i = 0; i < SpawnTypeTableSize; i++)
+	{
+		MapFilter filter = GetSpawnTypeFilter(static_cast<eSpawnType>(i));
+		s_spawnTypeVisible[i] = IsOptionEnabled(filter);
+	}
+	s_spawnTypeVisible[FLYER] = false;
+}
+
 // ---------------------------------------------------------------------------
 // More globals
 // ---------------------------------------------------------------------------
@@ -170,85 +252,188 @@ int HighlightPulseDiff = 1;
 
 char MapNameString[MAX_STRING] = "%N";
 char MapTargetNameString[MAX_STRING] = "%N";
-char mapshowStr[MAX_STRING] = { 0 };
-char maphideStr[MAX_STRING] = { 0 };
+LabelTemplate gMapNameTemplate;
+LabelTemplate gMapTargetNameTemplate;
 MQSpawnSearch MapFilterCustom;
 MQSpawnSearch MapFilterNamed;
+SpawnSearch MapFilterCustomSearch;
+SpawnSearch MapFilterNamedSearch;
 
 char MapSpecialClickString[MAX_CLICK_STRINGS][MAX_STRING] = { 0 };
 char MapLeftClickString[MAX_CLICK_STRINGS][MAX_STRING] = { 0 };
-bool repeatMapshow = false;
-bool repeatMaphide = false;
+LabelTemplate gMapSpecialClickTemplates[MAX_CLICK_STRINGS];
+LabelTemplate gMapLeftClickTemplates[MAX_CLICK_STRINGS];
 
 std::vector<MapFilterOption*> mapFilterObjectOptions;
 std::vector<MapFilterOption*> mapFilterGeneralOptions;
 
 MapObject* pLastTarget = nullptr;
+MapUpdateStats gMapUpdateStats;
+
+void MapCompileTemplates()
+{
+	gMapNameTemplate.Compile(MapNameString);
+	gMapTargetNameTemplate.Compile(MapTargetNameString);
+
+	for (int i = 0; i < MAX_CLICK_STRINGS; i++)
+	{
+		gMapSpecialClickTemplates[i].Compile(MapSpecialClickString[i]);
+		gMapLeftClickTemplates[i].Compile(MapLeftClickString[i]);
+	}
+}
 
 // ---------------------------------------------------------------------------
-// Label list management
+// Dirty tracking — objects are split into a dynamic set that is refreshed
+// every frame and a static set (corpses, ground items, map locs) that is
+// only revisited when something invalidates it. Settings that change how
+// every object is drawn bump the object epoch, which forces one full pass.
+// ---------------------------------------------------------------------------
+
+// Dynamic objects of each kind. Objects record their position here.
+static DenseArray<MapObject*> s_dynamicObjects[MapObjectKindCount];
+
+// Objects whose highlight pulses, whatever their kind
+static DenseArray<MapObject*> s_pulsingObjects;
+static int s_appliedPulseIndex = 0;
+
+static uint32_t s_objectEpoch = 1;
+static uint32_t s_fullPassEpoch = 1;
+static uint32_t s_nextLodCohort = 0;
+static int s_culledObjectCount = 0;
+
+void MapInvalidateObjects()
+{
+	++s_objectEpoch;
+}
+
+// ---------------------------------------------------------------------------
+// Storage — map objects, labels and lines all live in slot maps, one per
+// concrete type. Sized per zone by MapObjects_Reserve and returned to the
+// heap by MapObjects_ReleaseStorage once the map is cleared.
+// ---------------------------------------------------------------------------
+
+static SlotMap<MapObject, MapObjectSpawn> s_spawnObjects(256);
+static SlotMap<MapObject, MapObjectGroundSpawn> s_groundObjects(64);
+static SlotMap<MapObject, MapObjectMapLoc> s_mapLocObjects(16);
+
+// Set while MapObjects_Clear deletes everything
+static bool s_clearingObjects = false;
+
+// A label or line plus whether it is parked off the list handed to the
+// game (culled, or its label hidden). The game's struct comes first, so a
+// pointer to it is also a pointer to the node.
+template <typename T>
+struct ListNode
+{
+	T    Item;
+	bool Parked = false;
+};
+
+static SlotMap<ListNode<MAPLABEL>> s_labels(256);
+static SlotMap<ListNode<MapViewLine>> s_lines(1024);
+
+// ---------------------------------------------------------------------------
+// Game-facing lists — the game walks labels and lines through their own
+// pNext/pPrev. Unparked nodes are spliced in and out of gpLabelList and
+// gpLineList as they are made, deleted, parked and unparked, so MapAttach
+// hands the lists over as they stand. The slot maps only own the storage.
 // ---------------------------------------------------------------------------
 
 MAPLABEL* gpLabelList = nullptr;
 MAPLABEL* gpLabelListTail = nullptr;
+MapViewLine* gpLineList = nullptr;
+MapViewLine* gpLineListTail = nullptr;
 
-std::map<MAPLABEL*, MapObject*> LabelMap;
-
-static MAPLABEL* InitLabel()
+template <typename T>
+static void PushNode(T*& head, T*& tail, T* item)
 {
-	MAPLABEL* pLabel = new MAPLABEL;
-	pLabel->pPrev = nullptr;
-	pLabel->pNext = gpLabelList;
+	item->pPrev = nullptr;
+	item->pNext = head;
 
-	if (gpLabelList)
-		gpLabelList->pPrev = pLabel;
+	if (head)
+		head->pPrev = item;
 	else
-		gpLabelListTail = pLabel;
+		tail = item;
 
-	gpLabelList = pLabel;
-	return pLabel;
+	head = item;
 }
 
-static void DeleteLabel(MAPLABEL* pLabel)
+template <typename T>
+static void UnlinkNode(T*& head, T*& tail, T* item)
 {
-	if (pLabel->pNext)
-		pLabel->pNext->pPrev = pLabel->pPrev;
+	if (item->pNext)
+		item->pNext->pPrev = item->pPrev;
 	else
-		gpLabelListTail = pLabel->pPrev;
+		tail = item->pPrev;
 
-	if (pLabel->pPrev)
-		pLabel->pPrev->pNext = pLabel->pNext;
+	if (item->pPrev)
+		item->pPrev->pNext = item->pNext;
 	else
-		gpLabelList = pLabel->pNext;
+		head = item->pNext;
 
-	delete pLabel;
+	item->pPrev = nullptr;
+	item->pNext = nullptr;
 }
 
-MapObject* GetMapObjectForLabel(MAPLABEL* pLabel)
+template <typename T>
+static ListNode<T>* GetNode(T* item)
 {
-	auto iter = LabelMap.find(pLabel);
-	return iter == LabelMap.end() ? nullptr : iter->second;
+	return reinterpret_cast<ListNode<T>*>(item);
+}
+
+template <typename T>
+static void SetParked(T* item, bool parked, T*& head, T*& tail)
+{
+	ListNode<T>* node = GetNode(item);
+	if (node->Parked == parked)
+		return;
+
+	node->Parked = parked;
+
+	if (parked)
+		UnlinkNode(head, tail, item);
+	else
+		PushNode(head, tail, item);
 }
 
 // ---------------------------------------------------------------------------
-// Line list management
+// Label management
 // ---------------------------------------------------------------------------
 
-MapViewLine* gpLineList = nullptr;
-MapViewLine* gpLineListTail = nullptr;
+static PointerMap<MAPLABEL*, MapObject*> LabelMap;
 
-MapViewLine* InitLine()
+MAPLABEL* InitLabel()
+{
+	MAPLABEL* pLabel = &s_labels.New()->Item;
+	PushNode(gpLabelList, gpLabelListTail, pLabel);
+	return pLabel;
+}
+
+void DeleteLabel(MAPLABEL* pLabel)
 {
-	MapViewLine* pLine = new MapViewLine;
-	pLine->pPrev = nullptr;
-	pLine->pNext = gpLineList;
+	if (!pLabel)
+		return;
 
-	if (gpLineList)
-		gpLineList->pPrev = pLine;
-	else
-		gpLineListTail = pLine;
+	ListNode<MAPLABEL>* node = GetNode(pLabel);
+	if (!node->Parked)
+		UnlinkNode(gpLabelList, gpLabelListTail, pLabel);
+
+	s_labels.Delete(node);
+}
 
-	gpLineList = pLine;
+MapObject* GetMapObjectForLabel(MAPLABEL* pLabel)
+{
+	return LabelMap.Find(pLabel);
+}
+
+// ---------------------------------------------------------------------------
+// Line management
+// ---------------------------------------------------------------------------
+
+MapViewLine* InitLine()
+{
+	MapViewLine* pLine = &s_lines.New()->Item;
+	PushNode(gpLineList, gpLineListTail, pLine);
 	return pLine;
 }
 
@@ -257,43 +442,45 @@ void DeleteLine(MapViewLine* pLine)
 	if (!pLine)
 		return;
 
-	if (pLine->pNext)
-		pLine->pNext->pPrev = pLine->pPrev;
-	else
-		gpLineListTail = pLine->pPrev;
-
-	if (pLine->pPrev)
-		pLine->pPrev->pNext = pLine->pNext;
-	else
-		gpLineList = pLine->pNext;
+	ListNode<MapViewLine>* node = GetNode(pLine);
+	if (!node->Parked)
+		UnlinkNode(gpLineList, gpLineListTail, pLine);
 
-	delete pLine;
+	s_lines.Delete(node);
 }
 
 //============================================================================
 // MapObject base class
 //============================================================================
 
-MapObject::MapObject()
+MapObject::MapObject(MapObjectKind kind)
+	: m_kind(kind)
+	, m_epoch(s_objectEpoch)
+	, m_lodCohort(s_nextLodCohort++)
 {
-	m_pNext = gpActiveMapObjects;
-	if (gpActiveMapObjects)
-		gpActiveMapObjects->m_pLast = this;
-	gpActiveMapObjects = this;
+	SetDynamic(true);
 }
 
 void MapObject::PostInit()
 {
 	GenerateMarker();
 	Update(true);
+
+	// Prime the input cache so the first refresh doesn't redo this work
+	SampleInputs();
+	UpdateMobility(IsStationary());
 }
 
 MapObject::~MapObject()
 {
+	// Labels and lines are deleted wherever they are parked; this just
+	// keeps the culled count straight
+	SetCulled(false);
+
 	if (m_label)
 	{
+		LabelMap.Erase(m_label);
 		DeleteLabel(m_label);
-		LabelMap.erase(m_label);
 		m_label = nullptr;
 	}
 
@@ -305,13 +492,236 @@ MapObject::~MapObject()
 
 	RemoveMarker();
 
-	if (m_pNext)
-		m_pNext->m_pLast = m_pLast;
+	SetDynamic(false);
+	SetPulsing(false);
+}
+
+// The calls below are qualified with T, so they bind at compile time
+template <typename T>
+bool MapObject::Refresh(MapLodTier tier, bool due)
+{
+	T* self = static_cast<T*>(this);
+
+	bool pending = m_invalidated || m_epoch != s_objectEpoch;
+
+	// Nothing of a culled object is drawn; just keep up with where it is
+	if (m_culled)
+	{
+		CVector3 pos;
+		if (self->T::SamplePosition(pos))
+			m_pos = pos;
+		return false;
+	}
 
-	if (m_pLast)
-		m_pLast->m_pNext = m_pNext;
+	// Pending work is never deferred by LOD
+	if (!pending)
+	{
+		if (!due)
+			return false;
+
+		if (tier == MapLodTier::Far)
+		{
+			CVector3 pos;
+			return self->T::SamplePosition(pos) && RefreshPosition(pos);
+		}
+	}
+
+	bool changed = self->T::SampleInputs();
+	if (!changed && !pending)
+		return false;
+
+	bool forced = m_invalidated;
+	m_invalidated = false;
+	m_epoch = s_objectEpoch;
+
+	self->T::Update(forced);
+	UpdateMobility(self->T::IsStationary());
+	return true;
+}
+
+bool MapObject::RefreshPosition(const CVector3& pos)
+{
+	if (!test_and_set(m_pos, pos))
+		return false;
+
+	if (m_label)
+	{
+		m_label->Location.X = -m_pos.X;
+		m_label->Location.Y = -m_pos.Y;
+		m_label->Location.Z = m_pos.Z;
+	}
+
+	UpdateMarker();
+	return true;
+}
+
+void MapObject::Invalidate()
+{
+	m_invalidated = true;
+	SetDynamic(true);
+}
+
+void MapObject::Reconcile()
+{
+	if (m_label)
+		m_label->Layer = activeLayer;
+
+	// Marker shape and size come from the object's filter option
+	MarkerType marker = MarkerType::None;
+	uint32_t markerSize = 0;
+	if (IsOptionEnabled(MapFilter::Marker))
+	{
+		const MapFilterOption& option = GetMapFilterOption(GetMapFilter());
+		marker = option.Marker;
+		markerSize = option.MarkerSize;
+	}
+
+	if (marker != m_marker || (marker != MarkerType::None && markerSize != m_markerSize))
+	{
+		RemoveMarker();
+		GenerateMarker();
+	}
+	else
+	{
+		for (MapViewLine* line : m_markerLines)
+			line->Layer = activeLayer;
+	}
+
+	Invalidate();
+}
+
+void MapObject::SetHighlightSets(uint32_t sets)
+{
+	if (test_and_set(m_highlightSets, sets))
+		ResolveHighlight();
+}
+
+void MapObject::ResolveHighlight()
+{
+	const HighlightSet* set = MapHighlight_Resolve(m_highlightSets);
+	m_highlightColor = set ? set->Color : MQColor();
+	SetPulsing(set && set->Pulse);
+	Invalidate();
+}
+
+void MapObject::SetPulsing(bool pulsing)
+{
+	if (pulsing == IsPulsing())
+		return;
+
+	if (pulsing)
+	{
+		m_pulseIndex = static_cast<uint32_t>(s_pulsingObjects.size());
+		s_pulsingObjects.push_back(this);
+	}
+	else
+	{
+		MapObject* last = s_pulsingObjects.back();
+		s_pulsingObjects[m_pulseIndex] = last;
+		last->m_pulseIndex = m_pulseIndex;
+		s_pulsingObjects.pop_back();
+		m_pulseIndex = NoIndex;
+	}
+}
+
+void MapObject::UpdatePulsingMarkers()
+{
+	if (!test_and_set(s_appliedPulseIndex, HighlightPulseIndex))
+		return;
+
+	for (MapObject* mapObject : s_pulsingObjects)
+	{
+		if (!mapObject->m_culled)
+			mapObject->UpdateMarker();
+	}
+}
+
+bool MapObjects_HasPulsing()
+{
+	return !s_pulsingObjects.empty();
+}
+
+void MapObject::SetCulled(bool culled)
+{
+	if (!test_and_set(m_culled, culled))
+		return;
+
+	SetLabelHidden(LabelHide_Culled, culled);
+
+	for (MapViewLine* line : m_markerLines)
+		SetParked(line, culled, gpLineList, gpLineListTail);
+
+	if (m_vector)
+		SetParked(m_vector, culled, gpLineList, gpLineListTail);
+
+	if (culled)
+	{
+		++s_culledObjectCount;
+	}
 	else
-		gpActiveMapObjects = m_pNext;
+	{
+		--s_culledObjectCount;
+
+		// Whatever changed while parked still has to be applied
+		Invalidate();
+	}
+}
+
+void MapObject::SetLabelHidden(uint8_t reason, bool hidden)
+{
+	uint8_t mask = hidden ? (m_labelHidden | reason) : (m_labelHidden & ~reason);
+	bool wasHidden = m_labelHidden != 0;
+	m_labelHidden = mask;
+
+	if (!m_label || wasHidden == (mask != 0))
+		return;
+
+	SetParked(m_label, mask != 0, gpLabelList, gpLabelListTail);
+
+	if (mask == 0)
+		Invalidate();
+}
+
+MapViewLine* MapObject::AcquireLine()
+{
+	MapViewLine* pLine = InitLine();
+
+	if (m_culled)
+		SetParked(pLine, true, gpLineList, gpLineListTail);
+
+	return pLine;
+}
+
+void MapObject::ReleaseLine(MapViewLine* line)
+{
+	DeleteLine(line);
+}
+
+void MapObject::UpdateMobility(bool stationary)
+{
+	SetDynamic(!stationary);
+}
+
+void MapObject::SetDynamic(bool dynamic)
+{
+	if (dynamic == IsDynamic())
+		return;
+
+	DenseArray<MapObject*>& dynamicObjects = s_dynamicObjects[static_cast<size_t>(m_kind)];
+	if (dynamic)
+	{
+		m_dynamicIndex = static_cast<uint32_t>(dynamicObjects.size());
+		dynamicObjects.push_back(this);
+	}
+	else
+	{
+		// Move the last entry into this one's place
+		MapObject* last = dynamicObjects.back();
+		dynamicObjects[m_dynamicIndex] = last;
+		last->m_dynamicIndex = m_dynamicIndex;
+		dynamicObjects.pop_back();
+		m_dynamicIndex = NoIndex;
+	}
 }
 
 void MapObject::Update(bool forced)
@@ -323,9 +733,9 @@ void MapObject::Update(bool forced)
 		m_label->Location.Z = m_pos.Z;
 	}
 
-	if (m_highlight)
+	if (m_highlightSets)
 	{
-		SetColor(HighlightColor);
+		SetColor(m_highlightColor);
 	}
 
 	if (IsOptionEnabled(MapFilter::Marker))
@@ -339,61 +749,52 @@ bool MapObject::CanDisplayObject() const
 	return false;
 }
 
-std::string MapObject::FormatString(const char* formatString)
+void MapObject::SetTextFromTemplate(const LabelTemplate& labelTemplate)
 {
-	std::string sOutput;
+	char buffer[MAX_STRING];
+	LabelWriter out(buffer, sizeof(buffer));
 
-	for (int n = 0; formatString[n]; n++)
+	labelTemplate.Format(out, [this](char spec, LabelWriter& writer)
 	{
-		if (formatString[n] != '%')
-		{
-			sOutput.append(1, formatString[n]);
-			continue;
-		}
+		return HandleFormatSpecifier(spec, writer);
+	});
 
-		char spec = formatString[++n];
-		HandleFormatSpecifier(spec, sOutput);
-	}
-
-	return sOutput;
+	SetText(out.View());
 }
 
-void MapObject::HandleFormatSpecifier(char spec, std::string& sOutput)
+bool MapObject::HandleFormatSpecifier(char spec, LabelWriter& out)
 {
+	// std::to_string(float) precision, which labels have always used
+	constexpr int CoordPrecision = 6;
+
 	switch (spec)
 	{
 	case 'N':
 	case 'n':
-		sOutput.append(m_text);
-		return;
+		out.Append(m_text);
+		return true;
 
 	case 'h':
-		sOutput.append(1, '1');
-		return;
+		out.Append('1');
+		return true;
 
 	case 'i':
 	case 'l':
-		sOutput.append(1, '0');
-		return;
+		out.Append('0');
+		return true;
 
 	case 'x':
-		sOutput.append(std::to_string(m_pos.X));
-		return;
+		out.AppendFixed(m_pos.X, CoordPrecision);
+		return true;
 	case 'y':
-		sOutput.append(std::to_string(m_pos.Y));
-		return;
+		out.AppendFixed(m_pos.Y, CoordPrecision);
+		return true;
 	case 'z':
-		sOutput.append(std::to_string(m_pos.Z));
-		return;
-
-	case '%':
-		sOutput.append(1, '%');
-		return;
+		out.AppendFixed(m_pos.Z, CoordPrecision);
+		return true;
 
 	default:
-		sOutput.append(1, '%');
-		sOutput.append(1, spec);
-		return;
+		return false;
 	}
 }
 
@@ -417,21 +818,51 @@ void MapObject::GenerateLabel()
 	m_label->OffsetY = 0;
 	m_label->Label = "";
 
-	LabelMap[m_label] = this;
+	LabelMap.Insert(m_label, this);
 }
 
 void MapObject::SetText(std::string_view text)
 {
-	if (test_and_set(m_text, std::string(text)))
+	if (m_text != text)
 	{
-		if (m_label)
+		m_text.assign(text);
+		UpdateLabelText();
+	}
+}
+
+void MapObject::SetLabelDetail(LabelDetail detail)
+{
+	if (test_and_set(m_labelDetail, detail))
+		UpdateLabelText();
+}
+
+void MapObject::UpdateLabelText()
+{
+	if (!m_label)
+		return;
+
+	const std::string* text = &m_text;
+
+	if (m_labelDetail == LabelDetail::Abbreviated)
+	{
+		size_t length = static_cast<size_t>(MapLabelBudget_GetAbbreviatedLength());
+		if (m_text.size() > length)
 		{
-			if (m_text.empty())
-				m_label->Label = "";
-			else
-				m_label->Label = &m_text[0];
+			m_shortText.assign(m_text, 0, length);
+			m_shortText += '.';
+			text = &m_shortText;
 		}
 	}
+
+	if (text->empty())
+		m_label->Label = "";
+	else
+		m_label->Label = text->c_str();
+}
+
+float MapObject::GetLabelPriority() const
+{
+	return IsHighlighted() ? LabelPriority_Highlight : 0.0f;
 }
 
 void MapObject::SetColor(MQColor color)
@@ -455,23 +886,6 @@ void MapObject::SetPosition(const CVector3& pos)
 
 #pragma region Markers
 
-constexpr int MarkerSides_Triangle = 3;
-constexpr int MarkerSides_Square = 4;
-constexpr int MarkerSides_Diamond = 4;
-constexpr int MarkerSides_Ring = 8;
-
-static constexpr int GetNumMarkerSides(MarkerType type)
-{
-	switch (type)
-	{
-	case MarkerType::Triangle: return MarkerSides_Triangle;
-	case MarkerType::Square: return MarkerSides_Square;
-	case MarkerType::Diamond: return MarkerSides_Diamond;
-	case MarkerType::Ring: return MarkerSides_Ring;
-	default: return 0;
-	}
-}
-
 void MapObject::GenerateMarker()
 {
 	if (!IsOptionEnabled(MapFilter::Marker))
@@ -484,14 +898,14 @@ void MapObject::GenerateMarker()
 	if (m_marker == MarkerType::None)
 		return;
 
-	int sides = GetNumMarkerSides(m_marker);
+	int sides = GetMarkerLineCount(m_marker);
 
 	m_markerLines.clear();
 	m_markerLines.reserve(sides);
 
 	for (int i = 0; i < sides; i++)
 	{
-		MapViewLine* pNewLine = InitLine();
+		MapViewLine* pNewLine = AcquireLine();
 		pNewLine->Start.X = 0;
 		pNewLine->Start.Y = 0;
 		pNewLine->Start.Z = m_pos.Z;
@@ -513,275 +927,331 @@ void MapObject::RemoveMarker()
 		return;
 
 	for (MapViewLine* line : m_markerLines)
-		DeleteLine(line);
+		ReleaseLine(line);
 
 	m_markerLines.clear();
 	m_marker = MarkerType::None;
 }
 
+uint32_t MapObject::GetMarkerSideLength() const
+{
+	if (!m_highlightSets)
+		return m_markerSize;
+
+	if (IsPulsing())
+		return HighlightSIDELEN + (HighlightPulseIndex * HighlightPulseDiff);
+
+	return HighlightSIDELEN;
+}
+
 void MapObject::UpdateMarker()
 {
-	switch (m_marker)
-	{
-	case MarkerType::Triangle:
-		MakeTriangleMarker();
-		return;
-	case MarkerType::Square:
-		MakeSquareMarker();
-		return;
-	case MarkerType::Diamond:
-		MakeDiamondMarker();
-		return;
-	case MarkerType::Ring:
-		MakeRingMarker();
+	if (m_marker == MarkerType::None || m_markerLines.empty())
 		return;
 
-	default: break;
-	}
+	MarkerGeometry geometry;
+	geometry.Type = m_marker;
+	geometry.X = -m_pos.X;
+	geometry.Y = -m_pos.Y;
+	geometry.Z = m_pos.Z;
+	geometry.SideLength = GetMarkerSideLength();
+	geometry.Heading = m_heading;
+	geometry.ColorARGB = m_label->Color.ARGB;
+
+	BuildMarker(geometry, m_markerLines.data());
 }
 
-void MapObject::MakeSquareMarker()
-{
-	uint32_t markerSideLen = m_markerSize;
-	float x[2], y[2], X[2], Y[2];
+#pragma endregion
 
-	if (m_highlight)
-	{
-		if (HighlightPulse)
-		{
-			markerSideLen = HighlightSIDELEN + (HighlightPulseIndex * HighlightPulseDiff);
-		}
-		else
-		{
-			markerSideLen = HighlightSIDELEN;
-		}
-	}
+//============================================================================
+// MapObjectSpawn
+//============================================================================
 
-	x[0] = -m_pos.X - markerSideLen / 2;
-	x[1] = -m_pos.X + markerSideLen / 2;
-	y[0] = -m_pos.Y - markerSideLen / 2;
-	y[1] = -m_pos.Y + markerSideLen / 2;
+static PointerMap<SPAWNINFO*, MapObject*> SpawnMap;
 
-	for (int i = 0; i < GetNumMarkerSides(MarkerType::Square); i++)
-	{
-		switch (i)
-		{
-		case 0: X[0] = x[0]; X[1] = x[1]; Y[0] = y[0]; Y[1] = y[0]; break;
-		case 1: X[0] = x[1]; X[1] = x[1]; Y[0] = y[0]; Y[1] = y[1]; break;
-		case 2: X[0] = x[1]; X[1] = x[0]; Y[0] = y[1]; Y[1] = y[1]; break;
-		case 3: X[0] = x[0]; X[1] = x[0]; Y[0] = y[1]; Y[1] = y[0]; break;
-		}
+// Spawns whose motion track hasn't settled yet
+static DenseArray<MapObjectSpawn*> s_trackedSpawns;
 
-		m_markerLines[i]->Start.X = X[0];
-		m_markerLines[i]->Start.Y = Y[0];
-		m_markerLines[i]->End.X = X[1];
-		m_markerLines[i]->End.Y = Y[1];
-		m_markerLines[i]->Start.Z = m_pos.Z;
-		m_markerLines[i]->End.Z = m_pos.Z;
+void* MapObjectSpawn::operator new(size_t size)
+{
+	return s_spawnObjects.Allocate();
+}
 
-		if (m_markerLines[i]->Color.ARGB != m_label->Color.ARGB)
-			m_markerLines[i]->Color = m_label->Color;
-	}
+void MapObjectSpawn::operator delete(void* ptr, size_t size)
+{
+	s_spawnObjects.Free(ptr);
 }
 
-void MapObject::MakeTriangleMarker()
+MapObjectSpawn::MapObjectSpawn(SPAWNINFO* pSpawn, bool Explicit)
+	: MapObject(MapObjectKind::Spawn)
+	, m_spawn(pSpawn)
+	, m_name(MapNames_Intern(pSpawn))
+	, m_type(GetSpawnType(pSpawn))
+	, m_explicit(Explicit)
+	, m_rule(MapRules_Evaluate(pSpawn, m_name))
 {
-	uint32_t markerSideLen = m_markerSize;
-	float x[3], y[3], X[2], Y[2], Angle;
+	m_inputs.classInputs = GetSpawnClassInputs(pSpawn);
 
-	if (m_highlight)
-	{
-		if (HighlightPulse)
-		{
-			markerSideLen = HighlightSIDELEN + (HighlightPulseIndex * HighlightPulseDiff);
-		}
-		else
-		{
-			markerSideLen = HighlightSIDELEN;
-		}
-	}
+	GenerateLabel();
 
-	Angle = m_heading * 0.703125f;
-	x[0] = -m_pos.X + (markerSideLen * 1.5f) * sqrtf(3) / 3 * sinf((Angle + 180) / 180.0f * PI);
-	x[1] = -m_pos.X - (markerSideLen * 1.5f) * sqrtf(3) / 3 * sinf((Angle + 210) / 180.0f * PI);
-	x[2] = -m_pos.X + (markerSideLen * 1.5f) * sqrtf(3) / 3 * sinf((Angle + 330) / 180.0f * PI);
-	y[0] = -m_pos.Y + (markerSideLen * 1.5f) * sqrtf(3) / 3 * cosf((Angle + 180) / 180.0f * PI);
-	y[1] = -m_pos.Y - (markerSideLen * 1.5f) * sqrtf(3) / 3 * cosf((Angle + 210) / 180.0f * PI);
-	y[2] = -m_pos.Y + (markerSideLen * 1.5f) * sqrtf(3) / 3 * cosf((Angle + 330) / 180.0f * PI);
+	SetTextFromTemplate(gMapNameTemplate);
+	SetColor(GetSpawnColor());
 
-	for (int i = 0; i < GetNumMarkerSides(MarkerType::Triangle); i++)
-	{
-		switch (i)
-		{
-		case 0: X[0] = x[0]; X[1] = x[1]; Y[0] = y[0]; Y[1] = y[1]; break;
-		case 1: X[0] = x[1]; X[1] = x[2]; Y[0] = y[1]; Y[1] = y[2]; break;
-		case 2: X[0] = x[2]; X[1] = x[0]; Y[0] = y[2]; Y[1] = y[0]; break;
-		}
+	SpawnMap.Insert(m_spawn, this);
+}
 
-		m_markerLines[i]->Start.X = X[0];
-		m_markerLines[i]->Start.Y = Y[0];
-		m_markerLines[i]->End.X = X[1];
-		m_markerLines[i]->End.Y = Y[1];
-		m_markerLines[i]->Start.Z = m_pos.Z;
-		m_markerLines[i]->End.Z = m_pos.Z;
+MapObjectSpawn::~MapObjectSpawn()
+{
+	SpawnMap.Erase(m_spawn);
 
-		if (m_markerLines[i]->Color.ARGB != m_label->Color.ARGB)
-			m_markerLines[i]->Color = m_label->Color;
-	}
+	if (pLastTarget == this)
+		pLastTarget = nullptr;
+
+	// Kept off the map by a rule; remember it in case that changes. Not
+	// while the map is cleared, when the spawn may already be going away.
+	if (m_rule == MapRuleAction::Hide && !s_clearingObjects)
+		MapRules_OnSpawnHidden(m_spawn);
+
+	SetTracked(false);
+	RemoveVector();
 }
 
-void MapObject::MakeDiamondMarker()
+void MapObjectSpawn::RefreshRule()
 {
-	uint32_t markerSideLen = m_markerSize;
-	float x[3], y[3], X[2], Y[2];
+	m_rule = MapRules_Evaluate(m_spawn, m_name);
+}
 
-	if (m_highlight)
+void MapObjectSpawn::PostInit()
+{
+	MapObject::PostInit();
+
+	SetHighlightSets(MapHighlight_Evaluate(m_spawn, m_name));
+
+	if (IsOptionEnabled(MapFilter::Vector))
 	{
-		if (HighlightPulse)
-		{
-			markerSideLen = HighlightSIDELEN + (HighlightPulseIndex * HighlightPulseDiff);
-		}
-		else
-		{
-			markerSideLen = HighlightSIDELEN;
-		}
+		GenerateVector();
 	}
+}
+
+void MapObjectSpawn::Update(bool forced)
+{
+	bool changed = false;
+
+	changed |= test_and_set(m_type, GetSpawnType(m_spawn));
+
+	ReadPosition();
+	m_pos = GetShownPosition();
+	m_heading = SpawnAccess::GetHeading(m_spawn);
 
-	x[0] = -m_pos.X;
-	x[1] = -m_pos.X + markerSideLen * .71f;
-	x[2] = -m_pos.X - markerSideLen * .71f;
-	y[0] = -m_pos.Y - markerSideLen * .71f;
-	y[1] = -m_pos.Y;
-	y[2] = -m_pos.Y + markerSideLen * .71f;
+	bool isTarget = pLastTarget == this;
+	const LabelTemplate& labelTemplate = isTarget ? gMapTargetNameTemplate : gMapNameTemplate;
 
-	for (int i = 0; i < GetNumMarkerSides(MarkerType::Diamond); i++)
+	// Name may not have been populated when spawn was first created
+	// (e.g. during zone loading), so an empty label is always retried.
+	// Otherwise only reformat when a field the template reads changed.
+	bool reformat = changed || forced || m_text.empty()
+		|| (m_changedFields & labelTemplate.GetDependencies()) != 0;
+	m_changedFields = 0;
+
+	// A hidden label isn't drawn; it is reformatted when it is shown again
+	if (IsLabelHidden() && !m_text.empty())
+		reformat = false;
+
+	if (reformat)
 	{
-		switch (i)
-		{
-		case 0: X[0] = x[0]; X[1] = x[1]; Y[0] = y[0]; Y[1] = y[1]; break;
-		case 1: X[0] = x[1]; X[1] = x[0]; Y[0] = y[1]; Y[1] = y[2]; break;
-		case 2: X[0] = x[0]; X[1] = x[2]; Y[0] = y[2]; Y[1] = y[1]; break;
-		case 3: X[0] = x[2]; X[1] = x[0]; Y[0] = y[1]; Y[1] = y[0]; break;
-		}
+		SetTextFromTemplate(labelTemplate);
+		SetColor(GetSpawnColor());
+	}
+	else if (!IsHighlighted())
+	{
+		SetColor(GetSpawnColor());
+	}
 
-		m_markerLines[i]->Start.X = X[0];
-		m_markerLines[i]->Start.Y = Y[0];
-		m_markerLines[i]->End.X = X[1];
-		m_markerLines[i]->End.Y = Y[1];
-		m_markerLines[i]->Start.Z = m_pos.Z;
-		m_markerLines[i]->End.Z = m_pos.Z;
+	MapObject::Update(forced);
 
-		if (m_markerLines[i]->Color.ARGB != m_label->Color.ARGB)
-			m_markerLines[i]->Color = m_label->Color;
+	if (isTarget)
+	{
+		SetColor(GetMapFilterOption(MapFilter::Target).Color);
 	}
 }
 
-void MapObject::MakeRingMarker()
+bool MapObjectSpawn::SampleInputs()
 {
-	uint32_t markerSideLen = m_markerSize;
+	uint32_t fields = 0;
+	bool changed = false;
+
+	SpawnClassInputs classInputs = GetSpawnClassInputs(m_spawn);
+	if (classInputs.Race != m_inputs.classInputs.Race)
+		fields |= LabelField_Race;
+	if (classInputs.Class != m_inputs.classInputs.Class)
+		fields |= LabelField_Class;
+	bool reclassify = test_and_set(m_inputs.classInputs, classInputs);
 
-	if (m_highlight)
+	if (test_and_set(m_inputs.id, SpawnAccess::GetSpawnID(m_spawn)))
+		fields |= LabelField_ID;
+	if (test_and_set(m_inputs.pos, ReadPosition()))
 	{
-		if (HighlightPulse)
-		{
-			markerSideLen = HighlightSIDELEN + (HighlightPulseIndex * HighlightPulseDiff);
-		}
-		else
+		fields |= LabelField_Position;
+
+		// A flyer is an NPC whose position isn't set yet
+		reclassify |= m_inputs.type == FLYER;
+	}
+	if (test_and_set(m_inputs.level, SpawnAccess::GetLevel(m_spawn)))
+		fields |= LabelField_Level;
+	if (test_and_set(m_inputs.hp, SpawnAccess::GetHPCurrent(m_spawn)))
+		fields |= LabelField_HP;
+
+	// Names are only read again when they may have changed: corpses are
+	// renamed, and during zone loading they may not be filled in yet
+	if (reclassify || (fields & LabelField_Level) || MapNames_IsIncomplete(m_name))
+	{
+		if (test_and_set(m_name, MapNames_Intern(m_spawn)))
 		{
-			markerSideLen = HighlightSIDELEN;
+			fields |= LabelField_Name;
+			reclassify = true;
 		}
 	}
 
-	for (int i = 0; i < GetNumMarkerSides(MarkerType::Ring); i++)
-	{
-		m_markerLines[i]->Start.X = -m_pos.X + markerSideLen * sinf((i * 45 + 22.5f) / 180.0f * PI);
-		m_markerLines[i]->Start.Y = -m_pos.Y + markerSideLen * cosf((i * 45 + 22.5f) / 180.0f * PI);
-		m_markerLines[i]->End.X = -m_pos.X + markerSideLen * sinf(((i + 1) * 45 + 22.5f) / 180.0f * PI);
-		m_markerLines[i]->End.Y = -m_pos.Y + markerSideLen * cosf(((i + 1) * 45 + 22.5f) / 180.0f * PI);
-		m_markerLines[i]->Start.Z = m_pos.Z;
-		m_markerLines[i]->End.Z = m_pos.Z;
+	// The cached class isn't checked against the spawn on lookup; for a
+	// spawn on the map, this is where a change to it is noticed
+	if (reclassify)
+		SpawnClass_Invalidate(m_spawn);
+
+	eSpawnType type = GetSpawnType(m_spawn);
+	if (test_and_set(m_inputs.type, type))
+		fields |= LabelField_Type;
 
-		if (m_markerLines[i]->Color.ARGB != m_label->Color.ARGB)
-			m_markerLines[i]->Color = m_label->Color;
+	m_changedFields |= fields;
+	changed |= fields != 0;
+
+	// Cached search results, rule verdicts and highlight sets can depend
+	// on ID, type, level and name (a spawn seen before its name was filled
+	// in passed every name check)
+	if (fields & (LabelField_ID | LabelField_Type | LabelField_Level | LabelField_Name))
+	{
+		MapSearch_OnSpawnChanged(m_spawn, m_name);
+		RefreshRule();
+		SetHighlightSets((m_highlightSets & ~MapHighlight_SearchSets()) | MapHighlight_Evaluate(m_spawn, m_name));
 	}
-}
+	changed |= test_and_set(m_inputs.heading, SpawnAccess::GetHeading(m_spawn));
+	changed |= test_and_set(m_inputs.target, pLastTarget == this);
 
-#pragma endregion
+	// Con only matters when it drives the color
+	int con = 0;
+	if ((type == PC && IsOptionEnabled(MapFilter::PCConColor))
+		|| (type == NPC && IsOptionEnabled(MapFilter::NPCConColor)))
+	{
+		con = ConColor(m_spawn);
+	}
+	changed |= test_and_set(m_inputs.con, con);
 
-//============================================================================
-// MapObjectSpawn
-//============================================================================
+	// Name may not have been populated yet (zone loading); keep retrying
+	return changed || m_text.empty();
+}
 
-static std::map<SPAWNINFO*, MapObject*> SpawnMap;
+bool MapObjectSpawn::SamplePosition(CVector3& pos)
+{
+	ReadPosition();
+	pos = GetShownPosition();
+	return true;
+}
 
-MapObjectSpawn::MapObjectSpawn(SPAWNINFO* pSpawn, bool Explicit)
-	: m_spawn(pSpawn)
-	, m_type(GetSpawnType(pSpawn))
-	, m_explicit(Explicit)
+CVector3 MapObjectSpawn::ReadPosition()
 {
-	GenerateLabel();
+	CVector3 pos{ SpawnAccess::GetX(m_spawn), SpawnAccess::GetY(m_spawn), SpawnAccess::GetZ(m_spawn) };
 
-	SetText(FormatString(MapNameString));
-	SetColor(GetSpawnColor());
+	if (m_motion.Sample(pos) && gMapMotionEnabled && !m_motion.IsSettled())
+		SetTracked(true);
 
-	SpawnMap[m_spawn] = this;
+	return pos;
 }
 
-MapObjectSpawn::~MapObjectSpawn()
+CVector3 MapObjectSpawn::GetShownPosition() const
 {
-	SpawnMap.erase(m_spawn);
-
-	if (pLastTarget == this)
-		pLastTarget = nullptr;
-
-	RemoveVector();
+	return gMapMotionEnabled ? m_motion.Predict() : m_motion.GetLastSample();
 }
 
-void MapObjectSpawn::PostInit()
+void MapObjectSpawn::SetTracked(bool tracked)
 {
-	MapObject::PostInit();
+	if (tracked == IsTracked())
+		return;
 
-	if (IsOptionEnabled(MapFilter::Vector))
+	if (tracked)
 	{
-		GenerateVector();
+		m_trackIndex = static_cast<uint32_t>(s_trackedSpawns.size());
+		s_trackedSpawns.push_back(this);
+	}
+	else
+	{
+		MapObjectSpawn* last = s_trackedSpawns.back();
+		s_trackedSpawns[m_trackIndex] = last;
+		last->m_trackIndex = m_trackIndex;
+		s_trackedSpawns.pop_back();
+		m_trackIndex = UINT32_MAX;
 	}
 }
 
-void MapObjectSpawn::Update(bool forced)
+int MapObjectSpawn::MoveTracked()
 {
-	bool changed = false;
+	int moved = 0;
 
-	changed |= test_and_set(m_type, GetSpawnType(m_spawn));
+	// Walked backwards so a settled spawn can be swapped out in place
+	for (size_t i = s_trackedSpawns.size(); i-- > 0;)
+	{
+		MapObjectSpawn* mapObject = s_trackedSpawns[i];
 
-	m_pos.X = SpawnAccess::GetX(m_spawn);
-	m_pos.Y = SpawnAccess::GetY(m_spawn);
-	m_pos.Z = SpawnAccess::GetZ(m_spawn);
-	m_heading = SpawnAccess::GetHeading(m_spawn);
+		// The last move of a settled track lands on the position read
+		if (!gMapMotionEnabled || mapObject->m_motion.IsSettled())
+			mapObject->SetTracked(false);
 
-	if (changed || forced)
-	{
-		SetText(FormatString(MapNameString));
-		SetColor(GetSpawnColor());
-	}
-	else if (m_text.empty())
-	{
-		// Name may not have been populated when spawn was first created
-		// (e.g. during zone loading). Retry until we get a non-empty name.
-		SetText(FormatString(MapNameString));
-		SetColor(GetSpawnColor());
-	}
-	else if (!m_highlight)
-	{
-		SetColor(GetSpawnColor());
+		CVector3 pos = mapObject->GetShownPosition();
+		if (mapObject->IsCulled())
+		{
+			mapObject->m_pos = pos;
+		}
+		else if (mapObject->RefreshPosition(pos))
+		{
+			mapObject->UpdateVector();
+			moved++;
+		}
 	}
 
-	MapObject::Update(forced);
+	return moved;
+}
+
+bool MapObjectSpawn::IsStationary() const
+{
+	return m_type == CORPSE && pLastTarget != this;
+}
+
+float MapObjectSpawn::GetLabelPriority() const
+{
+	float priority = MapObject::GetLabelPriority();
 
 	if (pLastTarget == this)
+		priority += LabelPriority_Target;
+
+	switch (m_type)
 	{
-		SetColor(GetMapFilterOption(MapFilter::Target).Color);
-		SetText(FormatString(MapTargetNameString));
+	case PC:
+		priority += LabelPriority_Player;
+		break;
+
+	case NPC:
+		if (IsNamed(m_spawn))
+			priority += LabelPriority_Named;
+
+		switch (ConColor(m_spawn))
+		{
+		case CONCOLOR_YELLOW:
+		case CONCOLOR_RED:
+			priority += LabelPriority_Hostile;
+			break;
+		}
+		break;
 	}
+
+	return priority;
 }
 
 MQColor MapObjectSpawn::GetSpawnColor() const
@@ -837,59 +1307,60 @@ MQColor MapObjectSpawn::GetSpawnColor() const
 	return MQColor();
 }
 
-void MapObjectSpawn::HandleFormatSpecifier(char spec, std::string& sOutput)
+bool MapObjectSpawn::HandleFormatSpecifier(char spec, LabelWriter& out)
 {
+	constexpr int CoordPrecision = 6;
+
 	switch (spec)
 	{
 	case 'N':
-		sOutput.append(SpawnAccess::GetDisplayedName(m_spawn));
+		out.Append(MapNames_Get(m_name).Displayed);
 		if (m_type == CORPSE)
-			sOutput.append("'s Corpse");
-		return;
+			out.Append("'s Corpse");
+		return true;
 
 	case 'n':
-		sOutput.append(SpawnAccess::GetName(m_spawn));
-		return;
+		out.Append(MapNames_Get(m_name).Name);
+		return true;
 
 	case 'h':
-		sOutput.append(std::to_string(SpawnAccess::GetHPCurrent(m_spawn)));
-		return;
+		out.AppendNumber(SpawnAccess::GetHPCurrent(m_spawn));
+		return true;
 
 	case 'i':
-		sOutput.append(std::to_string(SpawnAccess::GetSpawnID(m_spawn)));
-		return;
+		out.AppendNumber(SpawnAccess::GetSpawnID(m_spawn));
+		return true;
 
 	case 'x':
-		sOutput.append(std::to_string(SpawnAccess::GetX(m_spawn)));
-		return;
+		out.AppendFixed(SpawnAccess::GetX(m_spawn), CoordPrecision);
+		return true;
 
 	case 'y':
-		sOutput.append(std::to_string(SpawnAccess::GetY(m_spawn)));
-		return;
+		out.AppendFixed(SpawnAccess::GetY(m_spawn), CoordPrecision);
+		return true;
 
 	case 'z':
-		sOutput.append(std::to_string(SpawnAccess::GetZ(m_spawn)));
-		return;
+		out.AppendFixed(SpawnAccess::GetZ(m_spawn), CoordPrecision);
+		return true;
 
 	case 'R':
-		sOutput.append(SpawnAccess::GetRaceString(m_spawn));
-		return;
+		out.Append(SpawnAccess::GetRaceString(m_spawn));
+		return true;
 
 	case 'C':
-		sOutput.append(SpawnAccess::GetClassString(m_spawn));
-		return;
+		out.Append(SpawnAccess::GetClassString(m_spawn));
+		return true;
 
 	case 'c':
-		sOutput.append(SpawnAccess::GetClassThreeLetterCode(m_spawn));
-		return;
+		out.Append(SpawnAccess::GetClassThreeLetterCode(m_spawn));
+		return true;
 
 	case 'l':
-		sOutput.append(std::to_string(SpawnAccess::GetLevel(m_spawn)));
-		return;
+		out.AppendNumber(static_cast<int>(SpawnAccess::GetLevel(m_spawn)));
+		return true;
 
 	default:
-		MapObject::HandleFormatSpecifier(spec, sOutput);
-		return;
+		return MapObject::HandleFormatSpecifier(spec, out);
 	}
 }
 
@@ -902,7 +1373,7 @@ MapFilter MapObjectSpawn::GetMapFilter() const
 	case NPC:
 		if (IsOptionEnabled(MapFilter::Named))
 		{
-			if (SpawnMatchesSearch(&MapFilterNamed, pLocalPlayer, m_spawn))
+			if (MapFilterNamedSearch.Matches(m_spawn, m_name))
 			{
 				return MapFilter::Named;
 			}
@@ -938,65 +1409,55 @@ MapFilter MapObjectSpawn::GetMapFilter() const
 	return MapObject::GetMapFilter();
 }
 
-static bool CanDisplaySpawnObject(eSpawnType type, SPAWNINFO* spawn)
+static bool CanDisplaySpawnObject(eSpawnType type, SPAWNINFO* spawn, MapRuleAction rule)
 {
 	if (spawn == pTarget && IsOptionEnabled(MapFilter::Target))
 	{
 		return true;
 	}
 
+	// Rules override the filters
+	if (rule != MapRuleAction::None)
+	{
+		return rule == MapRuleAction::Show;
+	}
+
 	if (IsOptionEnabled(MapFilter::Custom))
 	{
-		return SpawnMatchesSearch(&MapFilterCustom, pLocalPlayer, spawn);
+		return MapFilterCustomSearch.Matches(spawn);
 	}
 
 	switch (type)
 	{
-	case PC:
-		return IsOptionEnabled(MapFilter::PC);
 	case NPC:
 		if (IsOptionEnabled(MapFilter::Named))
 			return IsNamed(spawn);
-		else
-			return IsOptionEnabled(MapFilter::NPC);
+		break;
 	case CORPSE:
 		if (SpawnAccess::GetDeity(spawn) == 0)
 			return IsOptionEnabled(MapFilter::NPCCorpse);
 		else
 			return IsOptionEnabled(MapFilter::PCCorpse);
-	case ITEM:
-		return IsOptionEnabled(MapFilter::Ground);
-	case UNTARGETABLE:
-		return IsOptionEnabled(MapFilter::Untargetable);
-	case TIMER:
-		return IsOptionEnabled(MapFilter::Timer);
-	case TRAP:
-		return IsOptionEnabled(MapFilter::Trap);
-	case TRIGGER:
-		return IsOptionEnabled(MapFilter::Trigger);
-	case CHEST:
-		return IsOptionEnabled(MapFilter::Chest);
-	case PET:
-		return IsOptionEnabled(MapFilter::Pet);
-	case MOUNT:
-		return IsOptionEnabled(MapFilter::Mount);
-	case AURA:
-		return IsOptionEnabled(MapFilter::Aura);
-	case OBJECT:
-		return IsOptionEnabled(MapFilter::Object);
-	case BANNER:
-		return IsOptionEnabled(MapFilter::Banner);
-	case CAMPFIRE:
-		return IsOptionEnabled(MapFilter::Campfire);
-	case MERCENARY:
-		return IsOptionEnabled(MapFilter::Mercenary);
-	case FLYER:
-		return false;
 	}
 
+	if (type >= 0 && static_cast<size_t>(type) < SpawnTypeTableSize)
+		return s_spawnTypeVisible[type];
+
 	return true;
 }
 
+void MapObjectSpawn::Reconcile()
+{
+	MapObject::Reconcile();
+
+	if (!IsOptionEnabled(MapFilter::Vector))
+		RemoveVector();
+	else if (!m_vector)
+		GenerateVector();
+	else
+		m_vector->Layer = activeLayer;
+}
+
 bool MapObjectSpawn::CanDisplayObject() const
 {
 	if (m_explicit || MapObject::CanDisplayObject())
@@ -1004,14 +1465,14 @@ bool MapObjectSpawn::CanDisplayObject() const
 		return true;
 	}
 
-	return CanDisplaySpawnObject(m_type, m_spawn);
+	return CanDisplaySpawnObject(m_type, m_spawn, m_rule);
 }
 
 #pragma region Vectors
 
 void MapObjectSpawn::GenerateVector()
 {
-	MapViewLine* newLine = InitLine();
+	MapViewLine* newLine = AcquireLine();
 
 	UpdateVector();
 
@@ -1025,33 +1486,29 @@ void MapObjectSpawn::UpdateVector()
 {
 	if (!m_vector) return;
 
+	// Starts where the marker is drawn, which may be ahead of the spawn
+	m_vector->Start.X = -m_pos.X;
+	m_vector->Start.Y = -m_pos.Y;
+	m_vector->Start.Z = m_pos.Z;
+
 	if (SpawnAccess::GetSpeedRun(m_spawn) > 0)
 	{
-		m_vector->Start.X = -SpawnAccess::GetX(m_spawn);
-		m_vector->Start.Y = -SpawnAccess::GetY(m_spawn);
-		m_vector->Start.Z = SpawnAccess::GetZ(m_spawn);
-
-		m_vector->End.X = -SpawnAccess::GetX(m_spawn) - SpawnAccess::GetSpeedX(m_spawn) * 4;
-		m_vector->End.Y = -SpawnAccess::GetY(m_spawn) - SpawnAccess::GetSpeedY(m_spawn) * 4;
-		m_vector->End.Z = SpawnAccess::GetZ(m_spawn);
+		m_vector->End.X = -m_pos.X - SpawnAccess::GetSpeedX(m_spawn) * 4;
+		m_vector->End.Y = -m_pos.Y - SpawnAccess::GetSpeedY(m_spawn) * 4;
 	}
 	else
 	{
-		m_vector->Start.X = -SpawnAccess::GetX(m_spawn);
-		m_vector->Start.Y = -SpawnAccess::GetY(m_spawn);
-		m_vector->Start.Z = SpawnAccess::GetZ(m_spawn);
-
-		m_vector->End.X = -SpawnAccess::GetX(m_spawn) - sinf(SpawnAccess::GetHeading(m_spawn) / 256.0f * PI) * 4;
-		m_vector->End.Y = -SpawnAccess::GetY(m_spawn) - cosf(SpawnAccess::GetHeading(m_spawn) / 256.0f * PI) * 4;
-		m_vector->End.Z = SpawnAccess::GetZ(m_spawn);
+		m_vector->End.X = -m_pos.X - sinf(SpawnAccess::GetHeading(m_spawn) / 256.0f * PI) * 4;
+		m_vector->End.Y = -m_pos.Y - cosf(SpawnAccess::GetHeading(m_spawn) / 256.0f * PI) * 4;
 	}
+	m_vector->End.Z = m_pos.Z;
 }
 
 void MapObjectSpawn::RemoveVector()
 {
 	if (m_vector)
 	{
-		DeleteLine(m_vector);
+		ReleaseLine(m_vector);
 		m_vector = nullptr;
 	}
 }
@@ -1062,23 +1519,34 @@ void MapObjectSpawn::RemoveVector()
 // MapObjectGroundSpawn
 //============================================================================
 
-static std::map<EQGroundItem*, MapObject*> GroundItemMap;
+static PointerMap<EQGroundItem*, MapObject*> GroundItemMap;
+
+void* MapObjectGroundSpawn::operator new(size_t size)
+{
+	return s_groundObjects.Allocate();
+}
+
+void MapObjectGroundSpawn::operator delete(void* ptr, size_t size)
+{
+	s_groundObjects.Free(ptr);
+}
 
 MapObjectGroundSpawn::MapObjectGroundSpawn(EQGroundItem* pGroundItem)
-	: m_groundItem(pGroundItem)
+	: MapObject(MapObjectKind::GroundSpawn)
+	, m_groundItem(pGroundItem)
 	, m_friendlyName(GetFriendlyNameForGroundItem(m_groundItem))
 {
 	GenerateLabel();
 
-	SetText(FormatString(MapNameString));
+	SetTextFromTemplate(gMapNameTemplate);
 	SetColor(GetMapFilterOption(MapFilter::Ground).Color);
 
-	GroundItemMap[m_groundItem] = this;
+	GroundItemMap.Insert(m_groundItem, this);
 }
 
 MapObjectGroundSpawn::~MapObjectGroundSpawn()
 {
-	GroundItemMap.erase(m_groundItem);
+	GroundItemMap.Erase(m_groundItem);
 }
 
 void MapObjectGroundSpawn::PostInit()
@@ -1096,6 +1564,18 @@ void MapObjectGroundSpawn::Update(bool forced)
 	MapObject::Update(forced);
 }
 
+bool MapObjectGroundSpawn::SampleInputs()
+{
+	return m_pos.X != m_groundItem->X || m_pos.Y != m_groundItem->Y
+		|| m_pos.Z != m_groundItem->Z || m_heading != m_groundItem->Heading;
+}
+
+bool MapObjectGroundSpawn::SamplePosition(CVector3& pos)
+{
+	pos = CVector3{ m_groundItem->X, m_groundItem->Y, m_groundItem->Z };
+	return true;
+}
+
 MapFilter MapObjectGroundSpawn::GetMapFilter() const
 {
 	return MapFilter::Ground;
@@ -1111,18 +1591,19 @@ bool MapObjectGroundSpawn::CanDisplayObject() const
 	return IsOptionEnabled(MapFilter::Ground);
 }
 
-void MapObjectGroundSpawn::HandleFormatSpecifier(char spec, std::string& sOutput)
+bool MapObjectGroundSpawn::HandleFormatSpecifier(char spec, LabelWriter& out)
 {
 	switch (spec)
 	{
 	case 'N':
 	case 'n':
-		sOutput = m_friendlyName;
-		return;
+		// Replaces anything formatted so far, as it always has
+		out.Clear();
+		out.Append(m_friendlyName);
+		return true;
 
 	default:
-		MapObject::HandleFormatSpecifier(spec, sOutput);
-		return;
+		return MapObject::HandleFormatSpecifier(spec, out);
 	}
 }
 
@@ -1132,8 +1613,20 @@ void MapObjectGroundSpawn::HandleFormatSpecifier(char spec, std::string& sOutput
 
 MapObject* MakeMapObject(SPAWNINFO* pSpawn, bool Explicit)
 {
-	if (!Explicit && !CanDisplaySpawnObject(GetSpawnType(pSpawn), pSpawn))
-		return nullptr;
+	// Changes aren't noticed while a spawn is off the map (other than by a
+	// rule), so one coming back on is classified afresh
+	SpawnClass_Invalidate(pSpawn);
+
+	if (!Explicit)
+	{
+		MapRuleAction rule = MapRules_Evaluate(pSpawn);
+		if (!CanDisplaySpawnObject(GetSpawnType(pSpawn), pSpawn, rule))
+		{
+			if (rule == MapRuleAction::Hide)
+				MapRules_OnSpawnHidden(pSpawn);
+			return nullptr;
+		}
+	}
 
 	MapObject* obj = new MapObjectSpawn(pSpawn, Explicit);
 	obj->PostInit();
@@ -1143,14 +1636,7 @@ MapObject* MakeMapObject(SPAWNINFO* pSpawn, bool Explicit)
 
 MapObject* FindMapObject(SPAWNINFO* pSpawn)
 {
-	if (pSpawn)
-	{
-		auto iter = SpawnMap.find(pSpawn);
-		if (iter != SpawnMap.end())
-			return iter->second;
-	}
-
-	return nullptr;
+	return SpawnMap.Find(pSpawn);
 }
 
 MapObject* MakeMapObject(EQGroundItem* pGroundItem)
@@ -1166,27 +1652,239 @@ MapObject* MakeMapObject(EQGroundItem* pGroundItem)
 
 MapObject* FindMapObject(EQGroundItem* pGroundItem)
 {
-	if (pGroundItem)
+	return GroundItemMap.Find(pGroundItem);
+}
+
+void MapObjects_Reserve(size_t spawnCount, size_t groundItemCount)
+{
+	size_t objectCount = spawnCount + groundItemCount + gMapLocTemplates.size();
+
+	SpawnMap.Reserve(spawnCount);
+	GroundItemMap.Reserve(groundItemCount);
+	LabelMap.Reserve(objectCount);
+
+	// Lines: marker sides and heading vectors per object, the fixed map
+	// circles, and the target line.
+	size_t linesPerObject = 0;
+	if (IsOptionEnabled(MapFilter::Marker))
+		linesPerObject += GetMarkerLineCount(MarkerType::Square);
+	if (IsOptionEnabled(MapFilter::Vector))
+		linesPerObject += 1;
+
+	s_spawnObjects.Reserve(spawnCount);
+	s_groundObjects.Reserve(groundItemCount);
+	s_mapLocObjects.Reserve(gMapLocTemplates.size());
+	s_labels.Reserve(objectCount);
+	s_lines.Reserve(objectCount * linesPerObject + 6 * MapCircle::CIRCLE_MAX_SEGMENTS + 1);
+}
+
+template <typename T>
+static SlotMap<MapObject, T>& ObjectsOf();
+
+template <>
+SlotMap<MapObject, MapObjectSpawn>& ObjectsOf<MapObjectSpawn>() { return s_spawnObjects; }
+
+template <>
+SlotMap<MapObject, MapObjectGroundSpawn>& ObjectsOf<MapObjectGroundSpawn>() { return s_groundObjects; }
+
+template <>
+SlotMap<MapObject, MapObjectMapLoc>& ObjectsOf<MapObjectMapLoc>() { return s_mapLocObjects; }
+
+std::span<MapObject* const> MapObjects_Get(MapObjectKind kind)
+{
+	switch (kind)
 	{
-		auto iter = GroundItemMap.find(pGroundItem);
-		if (iter != GroundItemMap.end())
-			return iter->second;
+	case MapObjectKind::Spawn:
+		return { s_spawnObjects.begin(), s_spawnObjects.size() };
+	case MapObjectKind::GroundSpawn:
+		return { s_groundObjects.begin(), s_groundObjects.size() };
+	case MapObjectKind::MapLoc:
+		return { s_mapLocObjects.begin(), s_mapLocObjects.size() };
+	default:
+		return {};
 	}
+}
 
-	return nullptr;
+size_t MapObjects_Count()
+{
+	return s_spawnObjects.size() + s_groundObjects.size() + s_mapLocObjects.size();
 }
 
-void MapObjects_Clear()
+MapObject* MapObjects_Find(MapObjectKind kind, SlotHandle handle)
+{
+	switch (kind)
+	{
+	case MapObjectKind::Spawn:
+		return s_spawnObjects.Get(handle);
+	case MapObjectKind::GroundSpawn:
+		return s_groundObjects.Get(handle);
+	case MapObjectKind::MapLoc:
+		return s_mapLocObjects.Get(handle);
+	default:
+		return nullptr;
+	}
+}
+
+SlotHandle MapObject::GetHandle() const
+{
+	switch (m_kind)
+	{
+	case MapObjectKind::Spawn:
+		return s_spawnObjects.GetHandle(this);
+	case MapObjectKind::GroundSpawn:
+		return s_groundObjects.GetHandle(this);
+	case MapObjectKind::MapLoc:
+		return s_mapLocObjects.GetHandle(this);
+	default:
+		return {};
+	}
+}
+
+// Re-check which static objects of one kind are inside the visible region
+template <typename T>
+static void CullObjects()
+{
+	for (MapObject* object : ObjectsOf<T>())
+	{
+		T* mapObject = static_cast<T*>(object);
+		if (mapObject->T::CanCull() && mapObject != pLastTarget)
+			mapObject->SetCulled(!MapView_IsVisible(mapObject->GetPosition()));
+	}
+}
+
+// The per-frame walk over one kind's objects, or just its dynamic ones
+template <typename T>
+static void UpdateObjects(MapObjectKind kind, bool useLod, MapUpdateStats& stats)
+{
+	const SlotMap<MapObject, T>& objects = ObjectsOf<T>();
+	const DenseArray<MapObject*>& dynamicObjects = s_dynamicObjects[static_cast<size_t>(kind)];
+
+	// Backwards: a refresh may take this object out of the dynamic set, and
+	// it may be removed below. Either moves the last entry into its slot,
+	// and that one has already been visited. Entries are read through the
+	// arrays each time, since the dynamic one can grow during the walk.
+	for (size_t i = stats.fullPass ? objects.size() : dynamicObjects.size(); i-- > 0; )
+	{
+		T* mapObject = static_cast<T*>(stats.fullPass ? objects[i] : dynamicObjects[i]);
+
+		MapLodTier tier = MapLodTier::Near;
+		bool due = true;
+		if (useLod && mapObject != pLastTarget)
+		{
+			tier = MapLod_Classify(mapObject->GetPosition());
+			due = MapLod_IsDue(tier, mapObject->GetLodCohort());
+		}
+
+		switch (tier)
+		{
+		case MapLodTier::Near: stats.nearObjects++; break;
+		case MapLodTier::Mid: stats.midObjects++; break;
+		case MapLodTier::Far: stats.farObjects++; break;
+		}
+
+		if (mapObject->template Refresh<T>(tier, due))
+			stats.updatedObjects++;
+
+		// Dynamic objects can move across the edge of the visible region
+		if (mapObject->T::CanCull())
+		{
+			bool visible = mapObject == pLastTarget || MapView_IsVisible(mapObject->GetPosition());
+			if (visible == mapObject->IsCulled())
+			{
+				mapObject->SetCulled(!visible);
+
+				// Coming back into view: catch up now rather than a frame late
+				if (visible && mapObject->template Refresh<T>())
+					stats.updatedObjects++;
+			}
+		}
+
+		if (!mapObject->T::CanDisplayObject())
+		{
+			stats.removedObjects++;
+			delete mapObject;
+		}
+	}
+}
+
+void MapObjects_Update(MapUpdateStats& stats)
 {
-	GroundItemMap.clear();
-	SpawnMap.clear();
+	stats = MapUpdateStats{};
+	stats.totalObjects = static_cast<int>(MapObjects_Count());
 
-	while (gpActiveMapObjects)
+	// After an invalidation every object gets one pass, static or not
+	stats.fullPass = s_fullPassEpoch != s_objectEpoch;
+	s_fullPassEpoch = s_objectEpoch;
+
+	// A full pass applies settings everywhere, so it ignores LOD
+	bool useLod = gMapLodEnabled && !stats.fullPass;
+	if (useLod)
+		MapLod_BeginFrame();
+	MapMotion_BeginFrame();
+
+	// When the visible region moves, static objects have to be re-checked
+	// too. Anything brought back into view is invalidated, which puts it in
+	// the dynamic set for the walk below.
+	bool regionChanged = MapView_BeginFrame();
+	if (regionChanged && !stats.fullPass)
+	{
+		CullObjects<MapObjectSpawn>();
+		CullObjects<MapObjectGroundSpawn>();
+		CullObjects<MapObjectMapLoc>();
+	}
+
+	UpdateObjects<MapObjectSpawn>(MapObjectKind::Spawn, useLod, stats);
+	UpdateObjects<MapObjectGroundSpawn>(MapObjectKind::GroundSpawn, useLod, stats);
+	UpdateObjects<MapObjectMapLoc>(MapObjectKind::MapLoc, useLod, stats);
+
+	// Spawns between position updates glide on from their last sample
+	stats.movedObjects = MapObjectSpawn::MoveTracked();
+
+	MapObject::UpdatePulsingMarkers();
+
+	MapCluster_Update(regionChanged || stats.fullPass, stats);
+	MapLabelBudget_Update(regionChanged || stats.fullPass, stats);
+
+	stats.skippedObjects = stats.totalObjects - stats.updatedObjects;
+	for (const DenseArray<MapObject*>& dynamicObjects : s_dynamicObjects)
+		stats.dynamicObjects += static_cast<int>(dynamicObjects.size());
+	stats.culledObjects = s_culledObjectCount;
+}
+
+void MapObjects_ReleaseStorage()
+{
+	// Each slot map only lets go of its blocks if nothing in it is still
+	// alive, so a straggler can never be left dangling.
+	s_spawnObjects.Release();
+	s_groundObjects.Release();
+	s_mapLocObjects.Release();
+	s_labels.Release();
+	s_lines.Release();
+
+	for (DenseArray<MapObject*>& dynamicObjects : s_dynamicObjects)
 	{
-		delete gpActiveMapObjects;
+		if (dynamicObjects.empty())
+			dynamicObjects.release();
 	}
 }
 
+void MapObjects_Clear()
+{
+	MapCluster_Clear();
+
+	GroundItemMap.Clear();
+	SpawnMap.Clear();
+
+	s_clearingObjects = true;
+	while (!s_spawnObjects.empty())
+		delete s_spawnObjects[s_spawnObjects.size() - 1];
+	while (!s_groundObjects.empty())
+		delete s_groundObjects[s_groundObjects.size() - 1];
+	while (!s_mapLocObjects.empty())
+		delete s_mapLocObjects[s_mapLocObjects.size() - 1];
+	s_clearingObjects = false;
+}
+
 //============================================================================
 // MapCircle
 //============================================================================
@@ -1205,37 +1903,57 @@ void MapCircle::Clear()
 {
 	if (!m_initialized) return;
 
-	for (int i = 0; i < CIRCLE_NUM_SEGMENTS; i++)
+	SetSegmentCount(0);
+	m_initialized = false;
+}
+
+void MapCircle::SetSegmentCount(int segments)
+{
+	for (int i = segments; i < m_numSegments; i++)
 	{
-		if (m_components[i])
-		{
-			DeleteLine(m_components[i]);
-			m_components[i] = nullptr;
-		}
+		DeleteLine(m_components[i]);
+		m_components[i] = nullptr;
 	}
+
+	for (int i = m_numSegments; i < segments; i++)
+	{
+		m_components[i] = InitLine();
+		m_components[i]->Layer = activeLayer;
+	}
+
+	m_numSegments = segments;
 }
 
 void MapCircle::UpdateCircle(MQColor Color, float Radius, float X, float Y, float Z)
 {
-	uint32_t Angle = 0;
+	int segments = GetCircleSegments(Radius);
+	uint32_t colorARGB = Color.ToARGB();
+	CVector3 center{ X, Y, Z };
 
-	for (int i = 0; i < CIRCLE_NUM_SEGMENTS; i++, Angle += CIRCLE_ANGLESIZE)
+	if (m_initialized && segments == m_numSegments && colorARGB == m_colorARGB
+		&& Radius == m_radius && center == m_center)
 	{
-		if (!m_components[i])
-		{
-			m_components[i] = InitLine();
-			m_components[i]->Layer = activeLayer;
-		}
+		return;
+	}
 
-		m_components[i]->Color.ARGB = Color.ToARGB();
-		m_components[i]->Start.Z = Z;
-		m_components[i]->End.Z = Z;
-		m_components[i]->Start.X = -X + Radius * cosf((float)Angle / 180.0f * PI);
-		m_components[i]->Start.Y = -Y + Radius * sinf((float)Angle / 180.0f * PI);
-		m_components[i]->End.X = -X + Radius * cosf((float)(Angle + CIRCLE_ANGLESIZE) / 180.0f * PI);
-		m_components[i]->End.Y = -Y + Radius * sinf((float)(Angle + CIRCLE_ANGLESIZE) / 180.0f * PI);
+	SetSegmentCount(segments);
+
+	const SinCos* unit = GetUnitCircle(segments);
+	for (int i = 0; i < segments; i++)
+	{
+		MapViewLine* line = m_components[i];
+		line->Color.ARGB = colorARGB;
+		line->Start.Z = Z;
+		line->End.Z = Z;
+		line->Start.X = -X + Radius * unit[i].Cos;
+		line->Start.Y = -Y + Radius * unit[i].Sin;
+		line->End.X = -X + Radius * unit[i + 1].Cos;
+		line->End.Y = -Y + Radius * unit[i + 1].Sin;
 	}
 
+	m_colorARGB = colorARGB;
+	m_radius = Radius;
+	m_center = center;
 	m_initialized = true;
 }
 
@@ -1269,17 +1987,23 @@ MapLocTemplate::MapLocTemplate(const MapLocParams& params, const std::string& la
 
 MapLocTemplate::~MapLocTemplate()
 {
-	delete m_mapObject;
+	delete GetMapObject();
+}
+
+// The handle goes stale by itself when the map object is deleted
+MapObjectMapLoc* MapLocTemplate::GetMapObject() const
+{
+	return static_cast<MapObjectMapLoc*>(MapObjects_Find(MapObjectKind::MapLoc, m_mapObject));
 }
 
 void MapLocTemplate::CreateMapObject()
 {
-	if (m_mapObject == nullptr)
+	if (!GetMapObject())
 	{
 		MapObjectMapLoc* newLoc = new MapObjectMapLoc(this);
 		newLoc->SetPosition(m_pos);
 		newLoc->PostInit();
-		m_mapObject = newLoc;
+		m_mapObject = newLoc->GetHandle();
 
 		UpdateLabel();
 	}
@@ -1288,7 +2012,10 @@ void MapLocTemplate::CreateMapObject()
 void MapLocTemplate::SetSelected(bool selected)
 {
 	if (test_and_set(m_isSelected, selected))
-		m_mapObject->Update(true);
+	{
+		if (MapObjectMapLoc* mapObject = GetMapObject())
+			mapObject->Update(true);
+	}
 }
 
 void MapLocTemplate::SetIndex(int index)
@@ -1306,12 +2033,15 @@ void MapLocTemplate::SetLabel(const std::string& labelText)
 void MapLocTemplate::UpdateFromParams(const MapLocParams& params)
 {
 	m_mapLocParams = params;
-	m_mapObject->Update(true);
+
+	if (MapObjectMapLoc* mapObject = GetMapObject())
+		mapObject->Update(true);
 }
 
 void MapLocTemplate::UpdateLabel()
 {
-	if (!m_mapObject)
+	MapObjectMapLoc* mapObject = GetMapObject();
+	if (!mapObject)
 		return;
 
 	std::string label;
@@ -1326,15 +2056,26 @@ void MapLocTemplate::UpdateLabel()
 		label = std::to_string(m_index);
 	}
 
-	m_mapObject->SetText(label);
+	mapObject->SetText(label);
 }
 
 //============================================================================
 // MapObjectMapLoc
 //============================================================================
 
+void* MapObjectMapLoc::operator new(size_t size)
+{
+	return s_mapLocObjects.Allocate();
+}
+
+void MapObjectMapLoc::operator delete(void* ptr, size_t size)
+{
+	s_mapLocObjects.Free(ptr);
+}
+
 MapObjectMapLoc::MapObjectMapLoc(MapLocTemplate* pMapLoc)
-	: m_mapLoc(pMapLoc)
+	: MapObject(MapObjectKind::MapLoc)
+	, m_mapLoc(pMapLoc)
 {
 	GenerateLabel();
 
@@ -1343,7 +2084,6 @@ MapObjectMapLoc::MapObjectMapLoc(MapLocTemplate* pMapLoc)
 
 MapObjectMapLoc::~MapObjectMapLoc()
 {
-	m_mapLoc->OnMapObjectRemoved();
 	m_mapLoc = nullptr;
 
 	RemoveMapObject();
@@ -1377,101 +2117,101 @@ void MapObjectMapLoc::Update(bool forced)
 	}
 }
 
-void MapObjectMapLoc::UpdateMapObject()
+void MapObjectMapLoc::Reconcile()
 {
-	RemoveMapObject();
+	// The circle keeps its lines (and their layer) while its shape is
+	// unchanged; the forced update rebuilds it along with the X
+	m_circle.Clear();
 
-	MapViewLine* line = nullptr;
-	uint32_t colorARGB;
+	MapObject::Reconcile();
+}
 
-	const auto& params = m_mapLoc->GetParams();
+// Line segments of an X relative to its center, in map view coordinates
+struct XMarkerSegment
+{
+	float StartX, StartY;
+	float EndX, EndY;
+};
 
-	if (m_mapLoc->IsSelected())
-		colorARGB = params.color.GetInverted().ToARGB();
-	else
-		colorARGB = params.color.ToARGB();
+struct XMarkerShape
+{
+	float LineSize;
+	float Width;
+	std::vector<XMarkerSegment> Segments;
+};
+
+// Every loc with the same size and width shares one shape
+static const std::vector<XMarkerSegment>& GetXMarkerShape(float lineSize, float width)
+{
+	static std::deque<XMarkerShape> s_shapes;
+
+	for (const XMarkerShape& shape : s_shapes)
+	{
+		if (shape.LineSize == lineSize && shape.Width == width)
+			return shape.Segments;
+	}
+
+	XMarkerShape& shape = s_shapes.emplace_back(XMarkerShape{ lineSize, width });
+	const float s = lineSize;
 
-	// Create the X
-	for (int xWidth = 1; xWidth <= params.width; xWidth++)
+	for (int xWidth = 1; xWidth <= width; xWidth++)
 	{
 		if (xWidth == 1)
 		{
-			// Backslash
-			line = InitLine();
-			line->Layer = activeLayer;
-			line->Color.ARGB = colorARGB;
-			line->Start.X = -m_pos.X - params.lineSize;
-			line->Start.Y = -m_pos.Y - params.lineSize;
-			line->Start.Z = m_pos.Z;
-			line->End.X = -m_pos.X + params.lineSize;
-			line->End.Y = -m_pos.Y + params.lineSize;
-			line->End.Z = m_pos.Z;
-			m_lines.push_back(line);
-
-			// Forwardslash
-			line = InitLine();
-			line->Layer = activeLayer;
-			line->Color.ARGB = colorARGB;
-			line->Start.X = -m_pos.X - params.lineSize;
-			line->Start.Y = -m_pos.Y + params.lineSize;
-			line->Start.Z = m_pos.Z;
-			line->End.X = -m_pos.X + params.lineSize;
-			line->End.Y = -m_pos.Y - params.lineSize;
-			line->End.Z = m_pos.Z;
-			m_lines.push_back(line);
+			shape.Segments.push_back({ -s, -s, s, s });     // Backslash
+			shape.Segments.push_back({ -s, s, s, -s });     // Forwardslash
 		}
 		else
 		{
-			// Backslash lower
-			line = InitLine();
-			line->Layer = activeLayer;
-			line->Color.ARGB = colorARGB;
-			line->Start.X = -m_pos.X - params.lineSize;
-			line->Start.Y = -m_pos.Y - params.lineSize + xWidth - 1;
-			line->Start.Z = m_pos.Z;
-			line->End.X = -m_pos.X + params.lineSize - xWidth + 1;
-			line->End.Y = -m_pos.Y + params.lineSize;
-			line->End.Z = m_pos.Z;
-			m_lines.push_back(line);
-
-			// Forwardslash lower
-			line = InitLine();
-			line->Layer = activeLayer;
-			line->Color.ARGB = colorARGB;
-			line->Start.X = -m_pos.X - params.lineSize + xWidth - 1;
-			line->Start.Y = -m_pos.Y + params.lineSize;
-			line->Start.Z = m_pos.Z;
-			line->End.X = -m_pos.X + params.lineSize;
-			line->End.Y = -m_pos.Y - params.lineSize + xWidth - 1;
-			line->End.Z = m_pos.Z;
-			m_lines.push_back(line);
-
-			// Backslash upper
-			line = InitLine();
-			line->Layer = activeLayer;
-			line->Color.ARGB = colorARGB;
-			line->Start.X = -m_pos.X - params.lineSize + xWidth - 1;
-			line->Start.Y = -m_pos.Y - params.lineSize;
-			line->Start.Z = m_pos.Z;
-			line->End.X = -m_pos.X + params.lineSize;
-			line->End.Y = -m_pos.Y + params.lineSize - xWidth + 1;
-			line->End.Z = m_pos.Z;
-			m_lines.push_back(line);
-
-			// Forwardslash upper
-			line = InitLine();
-			line->Layer = activeLayer;
-			line->Color.ARGB = colorARGB;
-			line->Start.X = -m_pos.X - params.lineSize;
-			line->Start.Y = -m_pos.Y + params.lineSize - xWidth + 1;
-			line->Start.Z = m_pos.Z;
-			line->End.X = -m_pos.X + params.lineSize - xWidth + 1;
-			line->End.Y = -m_pos.Y - params.lineSize;
-			line->End.Z = m_pos.Z;
-			m_lines.push_back(line);
+			const float k = static_cast<float>(xWidth - 1);
+			shape.Segments.push_back({ -s, -s + k, s - k, s });     // Backslash lower
+			shape.Segments.push_back({ -s + k, s, s, -s + k });     // Forwardslash lower
+			shape.Segments.push_back({ -s + k, -s, s, s - k });     // Backslash upper
+			shape.Segments.push_back({ -s, s - k, s - k, -s });     // Forwardslash upper
 		}
 	}
 
+	return shape.Segments;
+}
+
+void MapObjectMapLoc::UpdateMapObject()
+{
+	const auto& params = m_mapLoc->GetParams();
+	const std::vector<XMarkerSegment>& shape = GetXMarkerShape(params.lineSize, params.width);
+
+	uint32_t colorARGB;
+	if (m_mapLoc->IsSelected())
+		colorARGB = params.color.GetInverted().ToARGB();
+	else
+		colorARGB = params.color.ToARGB();
+
+	// The lines are kept while the X has as many; they are just moved and
+	// recolored
+	if (m_lines.size() != shape.size())
+	{
+		for (MapViewLine* markerLine : m_lines)
+			DeleteLine(markerLine);
+		m_lines.clear();
+
+		m_lines.reserve(shape.size());
+		for (size_t i = 0; i < shape.size(); i++)
+			m_lines.push_back(InitLine());
+	}
+
+	for (size_t i = 0; i < shape.size(); i++)
+	{
+		const XMarkerSegment& segment = shape[i];
+		MapViewLine* line = m_lines[i];
+		line->Layer = activeLayer;
+		line->Color.ARGB = colorARGB;
+		line->Start.X = -m_pos.X + segment.StartX;
+		line->Start.Y = -m_pos.Y + segment.StartY;
+		line->Start.Z = m_pos.Z;
+		line->End.X = -m_pos.X + segment.EndX;
+		line->End.Y = -m_pos.Y + segment.EndY;
+		line->End.Z = m_pos.Z;
+	}
+
 	// Create the Radius
 	if (params.circleRadius > 0)
 	{
@@ -1523,17 +2263,14 @@ void UpdateDefaultMapLocInstances()
 			obj->UpdateFromParams(gDefaultMapLocParams);
 		}
 	}
+
+	// Their size may have changed, which the click index depends on
+	MapLocStore_OnChanged();
 }
 
 MapLocTemplate* GetMapLocTemplateByTag(std::string_view tag)
 {
-	for (auto& maplocTemplate : gMapLocTemplates)
-	{
-		if (maplocTemplate->GetTag() == tag)
-			return maplocTemplate.get();
-	}
-
-	return nullptr;
+	return MapLocStore_FindByTag(tag);
 }
 
 MapLocTemplate* GetMapLocByIndex(int index)
@@ -1555,6 +2292,7 @@ void CreateAllMapLocs()
 void DeleteAllMapLocs()
 {
 	gMapLocTemplates.clear();
+	MapLocStore_OnChanged();
 }
 
 static void UpdateMapLocIndexes()
@@ -1570,7 +2308,9 @@ void AddMapLoc(std::unique_ptr<MapLocTemplate> mapLoc)
 {
 	mapLoc->SetIndex((int)gMapLocTemplates.size() + 1);
 
+	MapLocTemplate* added = mapLoc.get();
 	gMapLocTemplates.push_back(std::move(mapLoc));
+	MapLocStore_OnAdded(added);
 }
 
 void DeleteMapLoc(MapLocTemplate* mapLoc)
@@ -1580,6 +2320,7 @@ void DeleteMapLoc(MapLocTemplate* mapLoc)
 		gMapLocTemplates.end());
 
 	UpdateMapLocIndexes();
+	MapLocStore_OnChanged();
 }
 
 void DeleteSelectedMapLocs()
@@ -1590,4 +2331,5 @@ void DeleteSelectedMapLocs()
 		gMapLocTemplates.end());
 
 	UpdateMapLocIndexes();
+	MapLocStore_OnChanged();
 }
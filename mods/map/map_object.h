@@ -10,7 +10,15 @@
 #pragma once
 
 #include "map.h"
-
+#include "map_geometry.h"
+#include "map_label_budget.h"
+#include "map_lod.h"
+#include "map_motion.h"
+#include "map_names.h"
+#include "map_rules.h"
+#include "slot_map.h"
+
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -18,16 +26,54 @@
 
 //============================================================================
 
+// Reasons an object's label can be kept off the attached list. The label is
+// only drawn while none of them apply.
+enum LabelHideReason : uint8_t
+{
+	LabelHide_Culled    = 0x01,   // outside the visible region
+	LabelHide_Clustered = 0x02,   // folded into a cluster count label
+	LabelHide_Budget    = 0x04,   // outside the per-frame label budget
+
+	LabelHide_All       = 0xff,
+};
+
+// How much of an object's text its label shows
+enum class LabelDetail : uint8_t
+{
+	Full,
+	Abbreviated,
+};
+
+// Concrete object types. Each is kept in its own dense array and updated by
+// its own loop, so the per-frame calls into it are direct.
+enum class MapObjectKind : uint8_t
+{
+	Spawn,
+	GroundSpawn,
+	MapLoc,
+
+	Count
+};
+
+constexpr size_t MapObjectKindCount = static_cast<size_t>(MapObjectKind::Count);
+
+//============================================================================
+
 class MapObject
 {
 public:
-	MapObject();
+	explicit MapObject(MapObjectKind kind);
 	virtual ~MapObject();
 
+	MapObjectKind GetKind() const { return m_kind; }
+
+	// Names this object until it is deleted; see MapObjects_Find
+	SlotHandle GetHandle() const;
+
 	virtual void PostInit();
 	virtual void Update(bool forced);
 
-	std::string FormatString(const char* str);
+	void SetTextFromTemplate(const LabelTemplate& labelTemplate);
 	virtual MapFilter GetMapFilter() const;
 
 	virtual bool CanDisplayObject() const;
@@ -35,20 +81,77 @@ public:
 	void SetText(std::string_view text);
 	std::string GetText() const { return m_text; }
 	void SetColor(MQColor color);
-
-	void SetHighlight(bool highlight) { m_highlight = highlight; }
+	MQColor GetColor() const { return m_color; }
+
+	// Highlight set membership (see map_highlight.h). The color and pulse
+	// are resolved when the sets or their settings change.
+	void SetHighlightSets(uint32_t sets);
+	uint32_t GetHighlightSets() const { return m_highlightSets; }
+	bool IsHighlighted() const { return m_highlightSets != 0; }
+	void ResolveHighlight();
+	bool IsPulsing() const { return m_pulseIndex != NoIndex; }
+
+	// Resize the markers of pulsing objects if the pulse has moved on since
+	// the last call. Called from MapObjects_Update.
+	static void UpdatePulsingMarkers();
 	void SetPosition(float x, float y, float z) { SetPosition(CVector3{ x, y, z }); }
 	void SetPosition(const CVector3& pos);
 	CVector3 GetPosition() const { return m_pos; }
 
-	MapObject* GetNext() const { return m_pNext; }
-	MapObject* GetPrev() const { return m_pLast; }
-
 	virtual SPAWNINFO* GetSpawn() const { return nullptr; }
 	virtual GROUNDITEM* GetGroundItem() const { return nullptr; }
 
+	// Per-frame entry point from MapUpdate. Samples the inputs the label and
+	// marker are built from and only runs Update() if one of them changed.
+	// Objects in a deferred LOD tier only refresh when due, and far ones
+	// only move. Returns true if the object was updated. T is the object's
+	// concrete type, which lets the calls it makes skip the vtable.
+	template <typename T>
+	bool Refresh(MapLodTier tier = MapLodTier::Near, bool due = true);
+
+	// Force a full update on the next refresh, even for a static object.
+	void Invalidate();
+
+	// Re-apply the settings an object only reads when it is built (layer,
+	// marker shape, heading vector) and force a full update, so a settings
+	// change doesn't need the object rebuilt.
+	virtual void Reconcile();
+	bool IsDynamic() const { return m_dynamicIndex != NoIndex; }
+	uint32_t GetLodCohort() const { return m_lodCohort; }
+
+	// Culled objects have their label and lines parked off the attached
+	// lists, and only track their position until they are back in view.
+	void SetCulled(bool culled);
+	bool IsCulled() const { return m_culled; }
+	virtual bool CanCull() const { return true; }
+
+	// Hidden labels are parked and not reformatted. Showing one again
+	// invalidates the object so its text catches up.
+	void SetLabelHidden(uint8_t reason, bool hidden);
+	bool IsLabelHidden(uint8_t reason = LabelHide_All) const { return (m_labelHidden & reason) != 0; }
+	bool HasLabel() const { return m_label != nullptr; }
+
+	// Objects compete for the label budget by this score; higher wins.
+	// Distance to the player is added on top by the budget pass.
+	virtual float GetLabelPriority() const;
+	void SetLabelDetail(LabelDetail detail);
+
 protected:
-	virtual void HandleFormatSpecifier(char spec, std::string& output);
+	// Write the value for a %-specifier. Returns false if it isn't one.
+	virtual bool HandleFormatSpecifier(char spec, LabelWriter& out);
+
+	// Read and cache this object's update inputs. Returns true if any changed.
+	virtual bool SampleInputs() { return false; }
+
+	// Read the live position, for the position-only LOD path. Returns false
+	// if the object has no position source of its own.
+	virtual bool SamplePosition(CVector3& pos) { return false; }
+	bool RefreshPosition(const CVector3& pos);
+
+	// Stationary objects can't change without an explicit Invalidate(), so
+	// they are left out of the per-frame dynamic set.
+	virtual bool IsStationary() const { return false; }
+	void UpdateMobility(bool stationary);
 
 	void GenerateLabel();
 
@@ -56,68 +159,140 @@ protected:
 	void UpdateMarker();
 	void RemoveMarker();
 
+	// Create or delete a line owned by this object. A new line starts out
+	// parked if the object is culled.
+	MapViewLine* AcquireLine();
+	void ReleaseLine(MapViewLine* line);
+
 	CVector3              m_pos;
 	float                 m_heading = 0.0f;
 
 private:
-	void MakeTriangleMarker();
-	void MakeSquareMarker();
-	void MakeDiamondMarker();
-	void MakeRingMarker();
+	uint32_t GetMarkerSideLength() const;
+	void UpdateLabelText();
 
 protected:
 	std::string           m_text;
+	std::string           m_shortText;     // abbreviated m_text, when in use
 	MQColor               m_color;
 	MapViewLabel*         m_label = nullptr;
 	MapViewLine*          m_vector = nullptr;
-	bool                  m_highlight = false;
+	uint32_t              m_highlightSets = 0;
+	MQColor               m_highlightColor;
 
 private:
 	MarkerType            m_marker = MarkerType::None;
 	uint32_t              m_markerSize = 0;
 	std::vector<MapViewLine*> m_markerLines;
-	MapObject*            m_pLast = nullptr;
-	MapObject*            m_pNext = nullptr;
+
+	void SetDynamic(bool dynamic);
+	void SetPulsing(bool pulsing);
+
+	static constexpr uint32_t NoIndex = UINT32_MAX;
+
+	MapObjectKind         m_kind;
+	uint32_t              m_dynamicIndex = NoIndex;   // slot in this kind's dynamic array
+	uint32_t              m_pulseIndex = NoIndex;     // slot in the pulsing array
+	bool                  m_invalidated = false;
+	uint32_t              m_epoch = 0;
+	uint32_t              m_lodCohort = 0;
+	bool                  m_culled = false;
+	uint8_t               m_labelHidden = 0;
+	LabelDetail           m_labelDetail = LabelDetail::Full;
 };
 
 //============================================================================
 
-class MapObjectSpawn : public MapObject
+class MapObjectSpawn final : public MapObject
 {
+	friend class MapObject;
+
 public:
 	MapObjectSpawn(SPAWNINFO* pSpawn, bool Explicit);
 	virtual ~MapObjectSpawn();
 
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 	virtual void PostInit() override;
 	virtual void Update(bool forced) override;
 
+	virtual void Reconcile() override;
+
 	virtual MapFilter GetMapFilter() const override;
 	virtual bool CanDisplayObject() const override;
 	virtual SPAWNINFO* GetSpawn() const { return m_spawn; }
 
 	MQColor GetSpawnColor() const;
+	virtual float GetLabelPriority() const override;
+
+	// Re-evaluate the show/hide rules for this spawn (see map_rules.h)
+	void RefreshRule();
+
+	// Move every spawn whose motion track is still running to where it is
+	// predicted to be this frame (see map_motion.h). Returns how many moved.
+	static int MoveTracked();
 
 private:
-	virtual void HandleFormatSpecifier(char spec, std::string& output) override;
+	virtual bool HandleFormatSpecifier(char spec, LabelWriter& out) override;
+	virtual bool SampleInputs() override;
+	virtual bool SamplePosition(CVector3& pos) override;
+	virtual bool IsStationary() const override;
 
 	void GenerateVector();
 	void UpdateVector();
 	void RemoveVector();
 
+	// Read the spawn's position and feed it to the motion track. Returns the
+	// position read.
+	CVector3 ReadPosition();
+
+	// Where the spawn is drawn this frame: the track's prediction, or the
+	// position last read when motion smoothing is off
+	CVector3 GetShownPosition() const;
+
+	void SetTracked(bool tracked);
+	bool IsTracked() const { return m_trackIndex != UINT32_MAX; }
+
 private:
-	SPAWNINFO* m_spawn = nullptr;
-	eSpawnType m_type = NONE;
-	bool       m_explicit = false;
+	SPAWNINFO*    m_spawn = nullptr;
+	NameID        m_name = NoName;
+	eSpawnType    m_type = NONE;
+	bool          m_explicit = false;
+	MapRuleAction m_rule = MapRuleAction::None;     // last rule verdict
+	MotionTrack   m_motion;
+	uint32_t      m_trackIndex = UINT32_MAX;       // slot in the tracked spawn array
+
+	// Inputs the label, color and marker were last built from
+	struct Inputs
+	{
+		CVector3   pos;
+		float      heading = 0.0f;
+		eSpawnType type = NONE;
+		uint8_t    level = 0;
+		uint32_t   id = 0;
+		int        hp = 0;
+		int        con = 0;
+		bool       target = false;
+		SpawnClassInputs classInputs;
+	};
+	Inputs     m_inputs;
+	uint32_t   m_changedFields = 0;    // LabelField bits changed since the last Update
 };
 
 //============================================================================
 
-class MapObjectGroundSpawn : public MapObject
+class MapObjectGroundSpawn final : public MapObject
 {
+	friend class MapObject;
+
 public:
 	MapObjectGroundSpawn(EQGroundItem* pGroundItem);
 	virtual ~MapObjectGroundSpawn();
 
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 	virtual void PostInit() override;
 	virtual void Update(bool forced) override;
 
@@ -127,7 +302,10 @@ public:
 	virtual GROUNDITEM* GetGroundItem() const override { return m_groundItem; }
 
 private:
-	virtual void HandleFormatSpecifier(char spec, std::string& output) override;
+	virtual bool HandleFormatSpecifier(char spec, LabelWriter& out) override;
+	virtual bool SampleInputs() override;
+	virtual bool SamplePosition(CVector3& pos) override;
+	virtual bool IsStationary() const override { return true; }
 
 private:
 	GROUNDITEM* m_groundItem = nullptr;
@@ -142,7 +320,36 @@ MapObject* FindMapObject(SPAWNINFO* pSpawn);
 MapObject* MakeMapObject(EQGroundItem* pGroundItem);
 MapObject* FindMapObject(EQGroundItem* pGroundItem);
 
+void MapObjects_Reserve(size_t spawnCount, size_t groundItemCount);
+void MapObjects_Update(MapUpdateStats& stats);
 void MapObjects_Clear();
+void MapObjects_ReleaseStorage();
+
+// Live objects of one kind, in no particular order. Valid until an object
+// of that kind is created or deleted.
+std::span<MapObject* const> MapObjects_Get(MapObjectKind kind);
+size_t MapObjects_Count();
+
+// True if any object's highlight pulses (drives the pulse timer)
+bool MapObjects_HasPulsing();
+
+// The object a handle names, or nullptr if it has since been deleted
+MapObject* MapObjects_Find(MapObjectKind kind, SlotHandle handle);
+
+// Calls fn for every live object. fn may delete the object it is given, but
+// must not create or delete any other.
+template <typename Fn>
+void MapObjects_ForEach(Fn&& fn)
+{
+	for (size_t kind = 0; kind < MapObjectKindCount; kind++)
+	{
+		// Backwards, so a removal (which moves the last object into the
+		// removed slot) only moves one that was already visited
+		std::span<MapObject* const> objects = MapObjects_Get(static_cast<MapObjectKind>(kind));
+		for (size_t i = objects.size(); i-- > 0; )
+			fn(objects[i]);
+	}
+}
 
 MapObject* GetMapObjectForLabel(MAPLABEL* pLabel);
 
@@ -151,8 +358,7 @@ MapObject* GetMapObjectForLabel(MAPLABEL* pLabel);
 class MapCircle
 {
 public:
-	static constexpr int CIRCLE_ANGLESIZE = 10;
-	static constexpr int CIRCLE_NUM_SEGMENTS = 360 / CIRCLE_ANGLESIZE;
+	static constexpr int CIRCLE_MAX_SEGMENTS = MaxCircleSegments;
 
 	MapCircle();
 	~MapCircle();
@@ -161,8 +367,16 @@ public:
 	void UpdateCircle(MQColor Color, float Radius, float X, float Y, float Z);
 
 private:
+	void SetSegmentCount(int segments);
+
 	bool m_initialized = false;
-	MapViewLine* m_components[CIRCLE_NUM_SEGMENTS];
+	int m_numSegments = 0;
+	MapViewLine* m_components[CIRCLE_MAX_SEGMENTS];
+
+	// What the lines were last built from, so an unchanged circle is free
+	uint32_t m_colorARGB = 0;
+	float m_radius = 0.0f;
+	CVector3 m_center;
 };
 
 //============================================================================
@@ -209,10 +423,9 @@ public:
 	void SetSelected(bool selected);
 	bool IsSelected() const { return m_isSelected; }
 
-	void OnMapObjectRemoved() { m_mapObject = nullptr; }
-
 private:
 	void UpdateLabel();
+	MapObjectMapLoc* GetMapObject() const;
 
 private:
 	int                   m_index = -1;
@@ -221,20 +434,35 @@ private:
 	std::string           m_tag;
 	CVector3              m_pos;
 	bool                  m_isCreatedFromDefaultLoc = false;
-	MapObjectMapLoc*      m_mapObject = nullptr;
+	SlotHandle            m_mapObject;
 	bool                  m_isSelected = false;
 };
 
-class MapObjectMapLoc : public MapObject
+class MapObjectMapLoc final : public MapObject
 {
+	friend class MapObject;
+
 public:
 	MapObjectMapLoc(MapLocTemplate* pMapLoc);
 	virtual ~MapObjectMapLoc();
 
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
+
 	virtual void PostInit() override;
 	virtual void Update(bool forced) override;
+	virtual void Reconcile() override;
 	virtual bool CanDisplayObject() const override { return true; }
 
+	// Map loc lines and circles aren't parked with the label and marker
+	virtual bool CanCull() const override { return false; }
+
+	// Placed by the user, so always labelled in full
+	virtual float GetLabelPriority() const override { return LabelPriority_Always; }
+
+protected:
+	virtual bool IsStationary() const override { return true; }
+
 private:
 	void UpdateMapObject();
 	void RemoveMapObject();
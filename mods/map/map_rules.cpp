@@ -0,0 +1,399 @@
+/**
+ * @file map_rules.cpp
+ * @brief Persistent /maphide and /mapshow rules.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_rules.h"
+#include "map_object.h"
+#include "map_names.h"
+#include "pointer_map.h"
+
+#include <algorithm>
+
+// ---------------------------------------------------------------------------
+// Rule set
+// ---------------------------------------------------------------------------
+
+static std::vector<MapRule> s_rules;
+static uint32_t s_nextRuleID = 1;
+
+const std::vector<MapRule>& MapRules_Get()
+{
+	return s_rules;
+}
+
+const char* MapRules_GetActionName(MapRuleAction action)
+{
+	switch (action)
+	{
+	case MapRuleAction::Show: return "show";
+	case MapRuleAction::Hide: return "hide";
+	default: return "none";
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Name matching
+// ---------------------------------------------------------------------------
+
+struct NameScan
+{
+	NameMatcher::Mask Name;
+	NameMatcher::Mask Displayed;
+	bool              Named = false;
+	bool              Valid = false;
+};
+
+static NameMatcher s_nameMatcher;
+static bool s_scanDisplayedNames = false;
+
+// Indexed by NameID. An ID always stands for the same names, so a scan
+// stays good until the matcher changes or the names are cleared.
+static std::vector<NameScan> s_nameScans;
+
+// Give every rule with a name its bit in the matcher
+static void RebuildNameMatcher()
+{
+	s_nameMatcher.Clear();
+	s_nameScans.clear();
+	s_scanDisplayedNames = false;
+
+	for (MapRule& rule : s_rules)
+	{
+		rule.ExactName = rule.Search.IsExactName();
+		rule.NamePattern = rule.Search.GetName().empty() ? -1
+			: s_nameMatcher.Add(rule.Search.GetName(), rule.ExactName);
+
+		// Contains also looks at the displayed name
+		if (rule.NamePattern >= 0 && !rule.ExactName)
+			s_scanDisplayedNames = true;
+	}
+
+	s_nameMatcher.Build();
+}
+
+static const NameScan& ScanNames(NameID id)
+{
+	if (id >= s_nameScans.size())
+		s_nameScans.resize(MapNames_Count() + 1);
+
+	NameScan& scan = s_nameScans[id];
+	if (scan.Valid)
+		return scan;
+
+	const InternedName& names = MapNames_Get(id);
+	scan.Name = s_nameMatcher.Scan(names.Name.c_str());
+	scan.Displayed = s_scanDisplayedNames
+		? s_nameMatcher.Scan(names.Displayed.c_str()) : NameMatcher::Mask{};
+	scan.Named = !names.Name.empty();
+	scan.Valid = true;
+	return scan;
+}
+
+static bool RuleMatches(const MapRule& rule, SPAWNINFO* pSpawn, NameID name, const NameScan& names)
+{
+	// Past the matcher's capacity, the rule scans the name itself
+	if (rule.NamePattern < 0)
+		return rule.Search.Matches(pSpawn, name);
+
+	// A spawn without a name passes the name check
+	if (names.Named && !names.Name[rule.NamePattern]
+		&& (rule.ExactName || !names.Displayed[rule.NamePattern]))
+	{
+		return false;
+	}
+
+	return rule.Search.Matches(pSpawn, false);
+}
+
+MapRuleAction MapRules_Evaluate(SPAWNINFO* pSpawn, NameID name)
+{
+	if (s_rules.empty())
+		return MapRuleAction::None;
+
+	NameScan names;
+	if (!s_nameMatcher.Empty())
+	{
+		if (name == UnknownName)
+			name = MapNames_Intern(pSpawn);
+		names = ScanNames(name);
+	}
+
+	// Last match wins, so walk from the newest rule back
+	for (auto it = s_rules.rbegin(); it != s_rules.rend(); ++it)
+	{
+		if (RuleMatches(*it, pSpawn, name, names))
+			return it->Action;
+	}
+
+	return MapRuleAction::None;
+}
+
+// Compile a rule without adding it. False if it can't be kept.
+static bool CompileRule(MapRule& rule, MapRuleAction action, const char* text)
+{
+	MQSpawnSearch search;
+	ClearSearchSpawn(&search);
+	ParseSearchSpawn(text, &search);
+
+	rule.Action = action;
+	rule.Text = text;
+	rule.Search.Compile(search);
+
+	return !rule.Search.IsPositional();
+}
+
+// ---------------------------------------------------------------------------
+// INI
+// ---------------------------------------------------------------------------
+
+static void SaveMapRules()
+{
+	WritePrivateProfileInt("Map Rules", "Count", static_cast<int>(s_rules.size()), INIFileName);
+
+	char key[32];
+	char value[MAX_STRING];
+	for (size_t i = 0; i < s_rules.size(); i++)
+	{
+		snprintf(key, sizeof(key), "Rule%u", static_cast<unsigned int>(i + 1));
+		snprintf(value, sizeof(value), "%s %s", MapRules_GetActionName(s_rules[i].Action), s_rules[i].Text.c_str());
+		WritePrivateProfileString("Map Rules", key, value, INIFileName);
+	}
+}
+
+void LoadMapRules()
+{
+	s_rules.clear();
+
+	int count = GetPrivateProfileInt("Map Rules", "Count", 0, INIFileName);
+	for (int i = 1; i <= count; i++)
+	{
+		char key[32];
+		snprintf(key, sizeof(key), "Rule%d", i);
+		std::string value = GetPrivateProfileString("Map Rules", key, "", INIFileName);
+
+		MapRuleAction action = MapRuleAction::None;
+		if (!_strnicmp(value.c_str(), "hide ", 5))
+			action = MapRuleAction::Hide;
+		else if (!_strnicmp(value.c_str(), "show ", 5))
+			action = MapRuleAction::Show;
+
+		MapRule rule;
+		if (action == MapRuleAction::None || !CompileRule(rule, action, value.c_str() + 5))
+		{
+			LogFramework("LoadMapRules: skipping %s='%s'", key, value.c_str());
+			continue;
+		}
+
+		rule.ID = s_nextRuleID++;
+		s_rules.push_back(std::move(rule));
+	}
+
+	RebuildNameMatcher();
+	LogFramework("LoadMapRules: %u rules", static_cast<unsigned int>(s_rules.size()));
+}
+
+// ---------------------------------------------------------------------------
+// Hidden spawns
+// ---------------------------------------------------------------------------
+
+// Type and level as of the last check. Rules can't be positional, so these
+// are the fields that can change under a rule (a name only changes with
+// the type). The class inputs are watched too, since nothing else looks at
+// a hidden spawn.
+struct HiddenSpawn
+{
+	SPAWNINFO* Spawn;
+	eSpawnType Type;
+	int        Level;
+	NameID     Name;
+	SpawnClassInputs ClassInputs;
+};
+
+static constexpr size_t RecheckHiddenPerFrame = 32;
+
+static std::vector<HiddenSpawn> s_hidden;
+static PointerMap<SPAWNINFO*, uint32_t> s_hiddenIndex;     // position + 1
+static size_t s_hiddenCursor = 0;
+
+void MapRules_OnSpawnHidden(SPAWNINFO* pSpawn)
+{
+	if (s_hiddenIndex.Contains(pSpawn))
+		return;
+
+	s_hidden.push_back({ pSpawn, GetSpawnType(pSpawn), SpawnAccess::GetLevel(pSpawn), MapNames_Intern(pSpawn),
+		GetSpawnClassInputs(pSpawn) });
+	s_hiddenIndex.Insert(pSpawn, static_cast<uint32_t>(s_hidden.size()));
+}
+
+static void EraseHidden(size_t index)
+{
+	s_hiddenIndex.Erase(s_hidden[index].Spawn);
+
+	if (index + 1 != s_hidden.size())
+	{
+		s_hidden[index] = s_hidden.back();
+		s_hiddenIndex.Insert(s_hidden[index].Spawn, static_cast<uint32_t>(index + 1));
+	}
+	s_hidden.pop_back();
+}
+
+void MapRules_OnSpawnRemoved(SPAWNINFO* pSpawn)
+{
+	if (uint32_t index = s_hiddenIndex.Find(pSpawn))
+		EraseHidden(index - 1);
+}
+
+// Recheck one hidden spawn. Returns true if it was let back on the map (and
+// its entry erased).
+static bool RecheckHidden(size_t index, bool force)
+{
+	HiddenSpawn& hidden = s_hidden[index];
+
+	// A flyer's position isn't watched here, so it is reclassified each time
+	bool reclassify = test_and_set(hidden.ClassInputs, GetSpawnClassInputs(hidden.Spawn))
+		|| hidden.Type == FLYER;
+
+	// Hidden before its name was filled in, it passed every name check.
+	// Corpses are renamed, which comes with a change of type.
+	bool changed = false;
+	if ((reclassify || MapNames_IsIncomplete(hidden.Name))
+		&& test_and_set(hidden.Name, MapNames_Intern(hidden.Spawn)))
+	{
+		changed = true;
+		reclassify = true;
+	}
+
+	if (reclassify)
+		SpawnClass_Invalidate(hidden.Spawn);
+
+	changed |= test_and_set(hidden.Type, GetSpawnType(hidden.Spawn));
+	changed |= test_and_set(hidden.Level, SpawnAccess::GetLevel(hidden.Spawn));
+
+	if (!(changed || force) || MapRules_Evaluate(hidden.Spawn, hidden.Name) == MapRuleAction::Hide)
+		return false;
+
+	SPAWNINFO* pSpawn = hidden.Spawn;
+	EraseHidden(index);
+	AddSpawn(pSpawn);
+	return true;
+}
+
+void MapRules_Update()
+{
+	if (s_hidden.empty())
+		return;
+
+	for (size_t checked = 0; checked < RecheckHiddenPerFrame && !s_hidden.empty(); checked++)
+	{
+		if (s_hiddenCursor >= s_hidden.size())
+			s_hiddenCursor = 0;
+
+		// An erased entry is replaced by the last one, which still needs a look
+		if (!RecheckHidden(s_hiddenCursor, false))
+			s_hiddenCursor++;
+	}
+}
+
+void MapRules_ClearHidden()
+{
+	s_hidden.clear();
+	s_hiddenIndex.Clear();
+	s_hiddenCursor = 0;
+	s_nameScans.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Rule changes
+// ---------------------------------------------------------------------------
+
+// Bring the map in line with a changed rule set. Returns how many spawns
+// left or joined the map.
+static int ApplyRules(const MapRule* added)
+{
+	int changed = 0;
+
+	// Spawn objects take their new verdict, and the ones it no longer
+	// allows go (a hidden one records itself as it is deleted)
+	MapObjects_ForEach([&](MapObject* mapObject) {
+		if (mapObject->GetKind() != MapObjectKind::Spawn)
+			return;
+
+		MapObjectSpawn* spawnObject = static_cast<MapObjectSpawn*>(mapObject);
+		spawnObject->RefreshRule();
+		if (!spawnObject->CanDisplayObject())
+		{
+			delete spawnObject;
+			changed++;
+		}
+	});
+
+	for (size_t i = s_hidden.size(); i-- > 0; )
+	{
+		if (RecheckHidden(i, true))
+			changed++;
+	}
+
+	// A new show rule can bring on spawns the filters left off, which
+	// nothing has a record of; its search finds them
+	if (added && added->Action == MapRuleAction::Show)
+	{
+		for (SPAWNINFO* pSpawn : MapSearch_Find(added->Search))
+		{
+			if (!FindMapObject(pSpawn) && AddSpawn(pSpawn))
+				changed++;
+		}
+	}
+
+	return changed;
+}
+
+const MapRule* MapRules_Add(MapRuleAction action, const char* text, int& changed)
+{
+	changed = 0;
+
+	MapRule rule;
+	if (!CompileRule(rule, action, text))
+		return nullptr;
+
+	rule.ID = s_nextRuleID++;
+	s_rules.push_back(std::move(rule));
+	RebuildNameMatcher();
+	SaveMapRules();
+
+	changed = ApplyRules(&s_rules.back());
+	return &s_rules.back();
+}
+
+bool MapRules_Remove(uint32_t id)
+{
+	auto iter = std::find_if(s_rules.begin(), s_rules.end(),
+		[id](const MapRule& rule) { return rule.ID == id; });
+	if (iter == s_rules.end())
+		return false;
+
+	s_rules.erase(iter);
+	RebuildNameMatcher();
+	SaveMapRules();
+	ApplyRules(nullptr);
+	return true;
+}
+
+int MapRules_Clear(MapRuleAction action)
+{
+	size_t before = s_rules.size();
+	std::erase_if(s_rules, [action](const MapRule& rule) {
+		return action == MapRuleAction::None || rule.Action == action;
+	});
+
+	int removed = static_cast<int>(before - s_rules.size());
+	if (removed)
+	{
+		RebuildNameMatcher();
+		SaveMapRules();
+		ApplyRules(nullptr);
+	}
+	return removed;
+}
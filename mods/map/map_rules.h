@@ -0,0 +1,87 @@
+/**
+ * @file map_rules.h
+ * @brief Persistent /maphide and /mapshow rules.
+ * @date 2026-10-17
+ *
+ * A rule is a spawn search compiled once (see SpawnSearch) together with
+ * what to do with the spawns it matches. Rules are checked in the order
+ * they were added and the last one that matches wins, so a /mapshow can
+ * carve an exception out of an earlier /maphide. A matching show rule
+ * puts a spawn on the map whatever the filters say; a matching hide rule
+ * keeps it off (the target is still shown when the Target filter is on).
+ *
+ * The name patterns of all rules are folded into one NameMatcher, so a
+ * spawn's name is scanned once however many rules there are, and the
+ * result is kept per interned name (see map_names.h) until the rules
+ * change.
+ *
+ * Rules are not rescans. A spawn is checked when its map object would be
+ * made (spawn added, MapGenerate, target) and again when its type, level
+ * or name changes, and each spawn object keeps the verdict it was last
+ * given. The spawns a hide rule kept off the map are remembered, so a
+ * change that lets one back on is noticed without walking the spawn list.
+ * Only adding or removing a rule touches everything, once.
+ *
+ * Rules outlive zoning and are saved to the INI:
+ *   [Map Rules]  Count, Rule1..RuleN = "hide <search>" / "show <search>"
+ *
+ * Searches with a radius or location depend on where everyone stands and
+ * can't be kept as rules; /maphide and /mapshow run those once instead.
+ */
+
+#pragma once
+
+#include "map.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class MapRuleAction : uint8_t
+{
+	None,
+	Show,
+	Hide,
+};
+
+struct MapRule
+{
+	uint32_t      ID = 0;
+	MapRuleAction Action = MapRuleAction::None;
+	std::string   Text;         // search as typed
+	SpawnSearch   Search;
+
+	int           NamePattern = -1;     // bit in the rule name matcher, -1 if none
+	bool          ExactName = false;
+};
+
+void LoadMapRules();
+
+// Compile and append a rule, save the rule set and apply it to the map;
+// changed is how many spawns left or joined the map. Returns the new rule,
+// or nullptr if the search can't be kept as a rule.
+const MapRule* MapRules_Add(MapRuleAction action, const char* text, int& changed);
+
+// Remove one rule by ID, or every rule with the given action (None for
+// all, returning how many went). The map is brought up to date.
+bool MapRules_Remove(uint32_t id);
+int MapRules_Clear(MapRuleAction action);
+
+const std::vector<MapRule>& MapRules_Get();
+const char* MapRules_GetActionName(MapRuleAction action);
+
+// Action of the last rule matching the spawn, or None. name is the spawn's
+// NameID, if the caller has it.
+MapRuleAction MapRules_Evaluate(SPAWNINFO* pSpawn, NameID name = UnknownName);
+
+// Hidden spawns: ones a hide rule kept off the map
+void MapRules_OnSpawnHidden(SPAWNINFO* pSpawn);
+void MapRules_OnSpawnRemoved(SPAWNINFO* pSpawn);
+
+// Rechecks the next slice of hidden spawns whose type, level or name changed,
+// and puts back the ones no longer hidden. Called from MapUpdate.
+void MapRules_Update();
+
+// Forget hidden spawns and cached name scans (spawn pointers don't survive
+// a zone)
+void MapRules_ClearHidden();
@@ -0,0 +1,384 @@
+/**
+ * @file map_search.cpp
+ * @brief Spawn searches compiled into a short list of predicate ops.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_search.h"
+#include "map_names.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <unordered_set>
+
+// ---------------------------------------------------------------------------
+// Compile
+// ---------------------------------------------------------------------------
+
+void SpawnSearch::Compile(const MQSpawnSearch& search)
+{
+	m_ops.clear();
+	m_name.clear();
+	m_nameResults.clear();
+	m_positional = search.bKnownLocation || search.FRadius < 9999.0 || search.ZRadius < 9999.0;
+
+	// Plain reads off the spawn come first, then the classification cache
+	// (a hash lookup), and the name scan last.
+	if (search.bSpawnID)
+		m_ops.push_back({ OpCode::SpawnID, search.SpawnID });
+
+	if (search.NotID)
+		m_ops.push_back({ OpCode::NotID, search.NotID });
+
+	// Level is a uint8_t, so a range covering 0..255 can't reject anything
+	if (search.MinLevel > 0 || search.MaxLevel < UINT8_MAX)
+	{
+		Op op{ OpCode::Level };
+		op.Min = search.MinLevel;
+		op.Max = search.MaxLevel;
+		m_ops.push_back(op);
+	}
+
+	if (search.bKnownLocation || search.FRadius < 9999.0)
+	{
+		float radius = static_cast<float>(search.FRadius);
+
+		// Squaring would turn a negative radius, which nothing is within,
+		// into a positive one
+		Op op{ search.bKnownLocation ? OpCode::LocRadius : OpCode::PlayerRadius };
+		op.X = search.xLoc;
+		op.Y = search.yLoc;
+		op.Range = radius < 0.0f ? -1.0f : radius * radius;
+		m_ops.push_back(op);
+	}
+
+	if (search.ZRadius < 9999.0)
+	{
+		Op op{ OpCode::ZRadius };
+		op.Range = static_cast<float>(search.ZRadius);
+		m_ops.push_back(op);
+	}
+
+	if (search.SpawnType != NONE)
+	{
+		Op op{ OpCode::Type };
+		op.Min = search.SpawnType;
+		m_ops.push_back(op);
+	}
+
+	if (search.bNoPet)
+		m_ops.push_back({ OpCode::NoPet });
+
+	if (search.bNamed)
+		m_ops.push_back({ OpCode::Named });
+
+	if (search.szName[0])
+	{
+		for (const char* c = search.szName; *c; c++)
+			m_name.push_back(LowerAscii(*c));
+
+		m_ops.push_back({ search.bExactName ? OpCode::ExactName : OpCode::NameContains });
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Match
+// ---------------------------------------------------------------------------
+
+bool SpawnSearch::IsExactName() const
+{
+	return std::any_of(m_ops.begin(), m_ops.end(),
+		[](const Op& op) { return op.Code == OpCode::ExactName; });
+}
+
+bool SpawnSearch::Matches(SPAWNINFO* pSpawn, NameID name, bool checkName) const
+{
+	if (!pSpawn)
+		return false;
+
+	const SpawnClass* spawnClass = nullptr;
+	auto getClass = [&]() {
+		if (!spawnClass)
+			spawnClass = GetSpawnClass(pSpawn);
+		return spawnClass;
+	};
+
+	for (const Op& op : m_ops)
+	{
+		switch (op.Code)
+		{
+		case OpCode::SpawnID:
+			if (SpawnAccess::GetSpawnID(pSpawn) != op.ID)
+				return false;
+			break;
+
+		case OpCode::NotID:
+			if (SpawnAccess::GetSpawnID(pSpawn) == op.ID)
+				return false;
+			break;
+
+		case OpCode::Level:
+		{
+			int level = SpawnAccess::GetLevel(pSpawn);
+			if (level < op.Min || level > op.Max)
+				return false;
+			break;
+		}
+
+		case OpCode::Type:
+			if (getClass()->Type != op.Min)
+				return false;
+			break;
+
+		case OpCode::NoPet:
+		{
+			eSpawnType type = getClass()->Type;
+			if (type == PET || type == MERCENARY)
+				return false;
+			break;
+		}
+
+		case OpCode::Named:
+			if (!getClass()->Named)
+				return false;
+			break;
+
+		case OpCode::LocRadius:
+		{
+			float dX = SpawnAccess::GetX(pSpawn) - op.X;
+			float dY = SpawnAccess::GetY(pSpawn) - op.Y;
+			if (dX * dX + dY * dY > op.Range)
+				return false;
+			break;
+		}
+
+		case OpCode::PlayerRadius:
+			if (SPAWNINFO* local = pLocalPlayer)
+			{
+				float dX = SpawnAccess::GetX(local) - SpawnAccess::GetX(pSpawn);
+				float dY = SpawnAccess::GetY(local) - SpawnAccess::GetY(pSpawn);
+				if (dX * dX + dY * dY > op.Range)
+					return false;
+			}
+			break;
+
+		case OpCode::ZRadius:
+			if (SPAWNINFO* local = pLocalPlayer)
+			{
+				if (fabsf(SpawnAccess::GetZ(local) - SpawnAccess::GetZ(pSpawn)) > op.Range)
+					return false;
+			}
+			break;
+
+		case OpCode::ExactName:
+		case OpCode::NameContains:
+			if (!checkName)
+				break;
+
+			if (name == UnknownName)
+				name = MapNames_Intern(pSpawn);
+			if (!MatchesName(name, op.Code))
+				return false;
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool SpawnSearch::MatchesName(NameID id, OpCode code) const
+{
+	if (m_nameGeneration != MapNames_GetGeneration())
+	{
+		m_nameResults.clear();
+		m_nameGeneration = MapNames_GetGeneration();
+	}
+
+	if (id >= m_nameResults.size())
+		m_nameResults.resize(MapNames_Count() + 1, NameResult::Unknown);
+
+	NameResult& result = m_nameResults[id];
+	if (result != NameResult::Unknown)
+		return result == NameResult::Passes;
+
+	const InternedName& names = MapNames_Get(id);
+	bool passes;
+	if (names.Name.empty())
+	{
+		// A spawn without a name passes the name check
+		passes = true;
+	}
+	else if (code == OpCode::ExactName)
+	{
+		passes = names.LowerName == m_name;
+	}
+	else
+	{
+		passes = names.LowerName.find(m_name) != std::string::npos
+			|| names.LowerDisplayed.find(m_name) != std::string::npos;
+	}
+
+	result = passes ? NameResult::Passes : NameResult::Fails;
+	return passes;
+}
+
+// ---------------------------------------------------------------------------
+// Materialized results
+// ---------------------------------------------------------------------------
+
+struct CachedSearch
+{
+	SpawnSearch                  Search;
+	std::unordered_set<uint32_t> SpawnIDs;
+	uint64_t                     LastUsed = 0;
+};
+
+static constexpr size_t MaxCachedSearches = 8;
+static constexpr int SweepSpawnsPerFrame = 32;
+
+static std::vector<std::unique_ptr<CachedSearch>> s_cachedSearches;
+static uint64_t s_useCounter = 0;
+static uint32_t s_sweepCursorID = 0;       // spawn the next slice starts at, 0 for the head
+static std::vector<SPAWNINFO*> s_results;
+
+static void Recheck(CachedSearch& cached, SPAWNINFO* pSpawn, NameID name)
+{
+	uint32_t spawnID = SpawnAccess::GetSpawnID(pSpawn);
+	if (cached.Search.Matches(pSpawn, name))
+		cached.SpawnIDs.insert(spawnID);
+	else
+		cached.SpawnIDs.erase(spawnID);
+}
+
+static CachedSearch& AddCachedSearch(SpawnSearch&& search)
+{
+	if (s_cachedSearches.size() >= MaxCachedSearches)
+	{
+		auto oldest = std::min_element(s_cachedSearches.begin(), s_cachedSearches.end(),
+			[](const auto& a, const auto& b) { return a->LastUsed < b->LastUsed; });
+		s_cachedSearches.erase(oldest);
+	}
+
+	auto cached = std::make_unique<CachedSearch>();
+	cached->Search = std::move(search);
+
+	// The one full scan this search will need
+	for (SPAWNINFO* pSpawn : WalkSpawns(pSpawnList))
+	{
+		if (cached->Search.Matches(pSpawn))
+			cached->SpawnIDs.insert(SpawnAccess::GetSpawnID(pSpawn));
+	}
+
+	s_cachedSearches.push_back(std::move(cached));
+	return *s_cachedSearches.back();
+}
+
+const std::vector<SPAWNINFO*>& MapSearch_Find(const MQSpawnSearch& search)
+{
+	return MapSearch_Find(SpawnSearch(search));
+}
+
+const std::vector<SPAWNINFO*>& MapSearch_Find(const SpawnSearch& compiled)
+{
+	s_results.clear();
+
+	if (compiled.IsPositional())
+	{
+		for (SPAWNINFO* pSpawn : WalkSpawns(pSpawnList))
+		{
+			if (compiled.Matches(pSpawn))
+				s_results.push_back(pSpawn);
+		}
+		return s_results;
+	}
+
+	auto iter = std::find_if(s_cachedSearches.begin(), s_cachedSearches.end(),
+		[&](const auto& cached) { return cached->Search == compiled; });
+	CachedSearch& cached = iter != s_cachedSearches.end() ? **iter : AddCachedSearch(SpawnSearch(compiled));
+	cached.LastUsed = ++s_useCounter;
+
+	for (auto it = cached.SpawnIDs.begin(); it != cached.SpawnIDs.end(); )
+	{
+		SPAWNINFO* pSpawn = GetSpawnByID(*it);
+		if (pSpawn && cached.Search.Matches(pSpawn))
+		{
+			s_results.push_back(pSpawn);
+			++it;
+		}
+		else
+		{
+			it = cached.SpawnIDs.erase(it);
+		}
+	}
+
+	return s_results;
+}
+
+void MapSearch_OnSpawnAdded(SPAWNINFO* pSpawn)
+{
+	for (auto& cached : s_cachedSearches)
+	{
+		if (cached->Search.Matches(pSpawn))
+			cached->SpawnIDs.insert(SpawnAccess::GetSpawnID(pSpawn));
+	}
+}
+
+void MapSearch_OnSpawnRemoved(SPAWNINFO* pSpawn)
+{
+	uint32_t spawnID = SpawnAccess::GetSpawnID(pSpawn);
+
+	// The next slice would have started here; start it at the following
+	// spawn instead, or at the head if that can't be read
+	if (s_sweepCursorID == spawnID)
+	{
+		SPAWNINFO* pNext = SpawnAccess::GetNext(pSpawn);
+		s_sweepCursorID = pNext && GameList::IsReadable(pNext, SpawnAccess::NodeSize)
+			? SpawnAccess::GetSpawnID(pNext) : 0;
+	}
+
+	for (auto& cached : s_cachedSearches)
+		cached->SpawnIDs.erase(spawnID);
+}
+
+void MapSearch_OnSpawnChanged(SPAWNINFO* pSpawn, NameID name)
+{
+	for (auto& cached : s_cachedSearches)
+		Recheck(*cached, pSpawn, name);
+}
+
+void MapSearch_Update()
+{
+	if (s_cachedSearches.empty())
+		return;
+
+	// The cursor is kept as an ID, since the spawn it names can go between
+	// frames; if it has, the sweep starts over
+	SPAWNINFO* pStart = s_sweepCursorID ? GetSpawnByID(s_sweepCursorID) : nullptr;
+
+	// Stops at the first spawn past this frame's slice, which is where the
+	// next frame starts
+	uint32_t nextID = 0;
+	int count = 0;
+	for (SPAWNINFO* pSpawn : WalkSpawns(pStart ? pStart : pSpawnList))
+	{
+		if (count++ == SweepSpawnsPerFrame)
+		{
+			nextID = SpawnAccess::GetSpawnID(pSpawn);
+			break;
+		}
+
+		MapSearch_OnSpawnChanged(pSpawn);
+	}
+
+	s_sweepCursorID = nextID;
+}
+
+void MapSearch_Clear()
+{
+	s_cachedSearches.clear();
+	s_sweepCursorID = 0;
+	s_results.clear();
+}
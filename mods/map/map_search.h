@@ -0,0 +1,131 @@
+/**
+ * @file map_search.h
+ * @brief Spawn searches compiled into a short list of predicate ops.
+ * @date 2026-10-17
+ *
+ * SpawnMatchesSearch looks at every field of an MQSpawnSearch on every
+ * call, even though a typical search ("npc orc", "id 1234") sets one or
+ * two. A SpawnSearch is compiled once from an MQSpawnSearch into only the
+ * checks it actually needs. The ops are ordered cheapest and most selective
+ * first, so most spawns are rejected by a single integer compare. The name
+ * is lowered once at compile time and distances are compared squared. The
+ * name check's result is kept per interned name (see map_names.h), so a
+ * highlight set or cached search looks at each distinct name only once.
+ *
+ * The result is identical to SpawnMatchesSearch for the fields it honours.
+ */
+
+#pragma once
+
+#include "../../mq_compat.h"
+#include "map_names.h"
+#include "name_matcher.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SpawnSearch
+{
+public:
+	SpawnSearch() = default;
+	explicit SpawnSearch(const MQSpawnSearch& search) { Compile(search); }
+
+	void Compile(const MQSpawnSearch& search);
+
+	// checkName false skips the name ops, for callers that have already
+	// matched the name (see NameMatcher). A caller holding the spawn's
+	// NameID passes it, which saves interning the names again.
+	bool Matches(SPAWNINFO* pSpawn, bool checkName = true) const { return Matches(pSpawn, UnknownName, checkName); }
+	bool Matches(SPAWNINFO* pSpawn, NameID name, bool checkName = true) const;
+
+	// The lowered name pattern, empty if the search doesn't look at names
+	const std::string& GetName() const { return m_name; }
+	bool IsExactName() const;
+
+	// True if the search accepts every spawn
+	bool MatchesAll() const { return m_ops.empty(); }
+
+	// True if the result depends on where spawns or the player are standing
+	bool IsPositional() const { return m_positional; }
+
+	bool operator==(const SpawnSearch& other) const
+	{
+		return m_ops == other.m_ops && m_name == other.m_name;
+	}
+
+private:
+	enum class OpCode : uint8_t
+	{
+		SpawnID,
+		NotID,
+		Level,
+		Type,
+		NoPet,
+		Named,
+		LocRadius,
+		PlayerRadius,
+		ZRadius,
+		ExactName,
+		NameContains,
+	};
+
+	struct Op
+	{
+		OpCode   Code;
+		uint32_t ID = 0;
+		int      Min = 0;
+		int      Max = 0;
+		float    X = 0.0f;
+		float    Y = 0.0f;
+		float    Range = 0.0f;    // squared for the radius ops
+
+		bool operator==(const Op&) const = default;
+	};
+
+	enum class NameResult : uint8_t
+	{
+		Unknown,
+		Passes,
+		Fails,
+	};
+
+	bool MatchesName(NameID id, OpCode code) const;
+
+	std::vector<Op> m_ops;
+	std::string     m_name;       // lowered
+	bool            m_positional = false;
+
+	// The name op's result per NameID. An ID always stands for the same
+	// names, so a result holds until they are cleared.
+	mutable std::vector<NameResult> m_nameResults;
+	mutable uint32_t                m_nameGeneration = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Materialized results
+//
+// /highlight, /maphide and /mapshow tend to repeat the same few searches.
+// The matching spawn IDs of the last few distinct searches are kept (least
+// recently used is dropped) and kept current from spawn add/remove events
+// and the type and level changes map objects notice, so repeating a search
+// costs its result count rather than a scan of every spawn. A slice of the
+// spawn list is rechecked each frame to pick up changes on spawns that
+// aren't on the map, and results are checked again as they are read, so a
+// stale ID never comes back out. Searches with a radius depend on where
+// everyone is standing and are always run in full.
+// ---------------------------------------------------------------------------
+
+// Spawns currently matching search. Valid until the next call.
+const std::vector<SPAWNINFO*>& MapSearch_Find(const MQSpawnSearch& search);
+const std::vector<SPAWNINFO*>& MapSearch_Find(const SpawnSearch& search);
+
+void MapSearch_OnSpawnAdded(SPAWNINFO* pSpawn);
+void MapSearch_OnSpawnRemoved(SPAWNINFO* pSpawn);
+void MapSearch_OnSpawnChanged(SPAWNINFO* pSpawn, NameID name = UnknownName);
+
+// Rechecks the next slice of the spawn list. Called from MapUpdate.
+void MapSearch_Update();
+
+// Drop every cached search (spawn IDs don't survive a zone)
+void MapSearch_Clear();
@@ -0,0 +1,372 @@
+/**
+ * @file map_view.cpp
+ * @brief Visible region of the map window, for culling labels and lines.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "map_view.h"
+
+#include <eqlib/Offsets.h>
+#include <eqlib/offsets/eqgame.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// Settings
+// ---------------------------------------------------------------------------
+
+bool gMapCullEnabled = true;
+
+static float s_margin = 64.0f;      // screen pixels
+
+static bool s_settingsChanged = true;
+
+void LoadMapViewSettings()
+{
+	gMapCullEnabled = GetPrivateProfileBool("Map Culling", "Enabled", gMapCullEnabled, INIFileName);
+	s_margin = std::max(0.0f, GetPrivateProfileFloat("Map Culling", "Margin", s_margin, INIFileName));
+
+	s_settingsChanged = true;
+}
+
+// ---------------------------------------------------------------------------
+// Window geometry
+// ---------------------------------------------------------------------------
+
+// CXWnd layout, as used by target_info.cpp
+constexpr uintptr_t CXWnd_ClipRectScreen = 0x088;   // CXRect: left, top, right, bottom
+
+struct ScreenRect
+{
+	int Left = 0;
+	int Top = 0;
+	int Right = 0;
+	int Bottom = 0;
+
+	bool operator==(const ScreenRect&) const = default;
+	bool IsEmpty() const { return Right <= Left || Bottom <= Top; }
+};
+
+static ScreenRect GetClipRect(void* mapViewMap)
+{
+	const int* rect = reinterpret_cast<const int*>(
+		reinterpret_cast<uintptr_t>(mapViewMap) + CXWnd_ClipRectScreen);
+	return { rect[0], rect[1], rect[2], rect[3] };
+}
+
+// Where the cursor is now, in the game's screen coordinates
+static bool GetCursorPoint(double& x, double& y)
+{
+	HWND hWnd = *reinterpret_cast<HWND*>(eqlib::FixEQGameOffset(__HWnd_x));
+	POINT point;
+	if (!hWnd || !GetCursorPos(&point) || !ScreenToClient(hWnd, &point))
+		return false;
+
+	x = point.x;
+	y = point.y;
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// View transform — world = A * screen + B, measured from mouse events
+// ---------------------------------------------------------------------------
+
+// Fit points closer than this to each other, or to the line through the
+// first two, don't pin the transform down (pixels)
+static constexpr double MinSpread = 8.0;
+
+// How far a point may land from where the transform puts it (pixels)
+static constexpr double Tolerance = 2.0;
+
+// A smaller scale than this is the map being dragged along under the
+// cursor, not a view (world units per pixel)
+static constexpr double MinScale = 0.001;
+
+struct ViewSample
+{
+	double X = 0.0;
+	double Y = 0.0;
+	double WorldX = 0.0;
+	double WorldY = 0.0;
+};
+
+struct ViewTransform
+{
+	double A[2][2] = {};
+	double B[2] = {};
+
+	void Apply(double x, double y, double& worldX, double& worldY) const
+	{
+		worldX = A[0][0] * x + A[0][1] * y + B[0];
+		worldY = A[1][0] * x + A[1][1] * y + B[1];
+	}
+
+	double Scale() const
+	{
+		return sqrt(fabs(A[0][0] * A[1][1] - A[0][1] * A[1][0]));
+	}
+};
+
+enum class ViewState
+{
+	Unknown,        // collecting fit points
+	Fitted,         // fitted, waiting for a point that agrees
+	Confirmed,      // safe to cull against
+};
+
+static ViewState s_state = ViewState::Unknown;
+static ViewSample s_fitPoints[3];
+static int s_fitPointCount = 0;
+static ViewTransform s_transform;
+static ScreenRect s_fitRect;        // the window's clip rect while measuring
+static ViewSample s_lastSample;     // the last mouse event's points
+static uint32_t s_viewGeneration = 0;
+static float s_scale = 0.0f;        // of the last confirmed transform
+
+static void ResetView()
+{
+	s_state = ViewState::Unknown;
+	s_fitPointCount = 0;
+}
+
+static bool Matches(const ViewSample& sample)
+{
+	double worldX, worldY;
+	s_transform.Apply(sample.X, sample.Y, worldX, worldY);
+
+	double tolerance = Tolerance * s_transform.Scale();
+	return fabs(worldX - sample.WorldX) <= tolerance && fabs(worldY - sample.WorldY) <= tolerance;
+}
+
+static bool IsNearFitPoint(const ViewSample& sample)
+{
+	for (int i = 0; i < s_fitPointCount; i++)
+	{
+		if (hypot(sample.X - s_fitPoints[i].X, sample.Y - s_fitPoints[i].Y) < MinSpread)
+			return true;
+	}
+	return false;
+}
+
+// Solve A and B from the three fit points
+static bool FitTransform()
+{
+	const ViewSample& p0 = s_fitPoints[0];
+	const ViewSample& p1 = s_fitPoints[1];
+	const ViewSample& p2 = s_fitPoints[2];
+
+	double d1x = p1.X - p0.X, d1y = p1.Y - p0.Y;
+	double d2x = p2.X - p0.X, d2y = p2.Y - p0.Y;
+	double e1x = p1.WorldX - p0.WorldX, e1y = p1.WorldY - p0.WorldY;
+	double e2x = p2.WorldX - p0.WorldX, e2y = p2.WorldY - p0.WorldY;
+	double det = d1x * d2y - d2x * d1y;
+
+	ViewTransform transform;
+	transform.A[0][0] = (e1x * d2y - e2x * d1y) / det;
+	transform.A[0][1] = (e2x * d1x - e1x * d2x) / det;
+	transform.A[1][0] = (e1y * d2y - e2y * d1y) / det;
+	transform.A[1][1] = (e2y * d1x - e1y * d2x) / det;
+	transform.B[0] = p0.WorldX - transform.A[0][0] * p0.X - transform.A[0][1] * p0.Y;
+	transform.B[1] = p0.WorldY - transform.A[1][0] * p0.X - transform.A[1][1] * p0.Y;
+
+	double scale = transform.Scale();
+	if (!std::isfinite(scale) || scale < MinScale)
+		return false;
+
+	s_transform = transform;
+	return true;
+}
+
+static void AddFitPoint(const ViewSample& sample)
+{
+	if (s_fitPointCount == 1 && IsNearFitPoint(sample))
+		return;
+
+	if (s_fitPointCount == 2)
+	{
+		const ViewSample& p0 = s_fitPoints[0];
+		double d1x = s_fitPoints[1].X - p0.X, d1y = s_fitPoints[1].Y - p0.Y;
+		double d2x = sample.X - p0.X, d2y = sample.Y - p0.Y;
+		if (fabs(d1x * d2y - d2x * d1y) < MinSpread * hypot(d1x, d1y))
+			return;
+	}
+
+	s_fitPoints[s_fitPointCount++] = sample;
+	if (s_fitPointCount < 3)
+		return;
+
+	if (FitTransform())
+	{
+		s_state = ViewState::Fitted;
+	}
+	else
+	{
+		ResetView();
+		s_fitPoints[s_fitPointCount++] = sample;
+	}
+}
+
+void MapView_OnMouseEvent(void* mapViewMap, const CXPoint& pos, bool zoomed)
+{
+	CVector3 world;
+	if (!CallGetWorldCoordinates(mapViewMap, world))
+		return;
+
+	ViewSample sample;
+	sample.X = pos.x;
+	sample.Y = pos.y;
+	sample.WorldX = world.X;
+	sample.WorldY = world.Y;
+	s_lastSample = sample;
+
+	// Moving or resizing the window moves the map on screen, and the wheel
+	// zooms it; either way the points so far no longer apply
+	ScreenRect rect = GetClipRect(mapViewMap);
+	if (zoomed || rect != s_fitRect)
+	{
+		ResetView();
+		s_fitRect = rect;
+	}
+
+	switch (s_state)
+	{
+	case ViewState::Unknown:
+		AddFitPoint(sample);
+		break;
+
+	case ViewState::Fitted:
+		if (IsNearFitPoint(sample))
+			break;
+
+		if (Matches(sample))
+		{
+			s_state = ViewState::Confirmed;
+			s_scale = static_cast<float>(s_transform.Scale());
+			++s_viewGeneration;
+			break;
+		}
+
+		ResetView();
+		AddFitPoint(sample);
+		break;
+
+	case ViewState::Confirmed:
+		if (!Matches(sample))
+		{
+			ResetView();
+			AddFitPoint(sample);
+		}
+		break;
+	}
+}
+
+// True if the confirmed transform still describes what the map shows
+static bool CheckView(void* mapViewMap)
+{
+	if (s_state != ViewState::Confirmed)
+		return false;
+
+	CVector3 world;
+	if (GetClipRect(mapViewMap) != s_fitRect || !CallGetWorldCoordinates(mapViewMap, world))
+	{
+		ResetView();
+		return false;
+	}
+
+	// GetWorldCoordinates works from the mouse: either the last point the
+	// map saw it at, or wherever the cursor is now
+	ViewSample sample = s_lastSample;
+	sample.WorldX = world.X;
+	sample.WorldY = world.Y;
+	if (Matches(sample))
+		return true;
+
+	if (GetCursorPoint(sample.X, sample.Y) && Matches(sample))
+		return true;
+
+	// Panned or zoomed since the transform was measured
+	ResetView();
+	return false;
+}
+
+// ---------------------------------------------------------------------------
+// Visible region
+// ---------------------------------------------------------------------------
+
+static bool s_hasRegion = false;
+static uint32_t s_regionGeneration = 0;
+static float s_minX = 0.0f;
+static float s_maxX = 0.0f;
+static float s_minY = 0.0f;
+static float s_maxY = 0.0f;
+
+// The window's clip rect plus the margin, carried into the world
+static void SetRegion()
+{
+	double left = s_fitRect.Left - s_margin;
+	double top = s_fitRect.Top - s_margin;
+	double right = s_fitRect.Right + s_margin;
+	double bottom = s_fitRect.Bottom + s_margin;
+
+	const double corners[4][2] = { { left, top }, { right, top }, { left, bottom }, { right, bottom } };
+
+	double minX = DBL_MAX, maxX = -DBL_MAX, minY = DBL_MAX, maxY = -DBL_MAX;
+	for (const auto& corner : corners)
+	{
+		double worldX, worldY;
+		s_transform.Apply(corner[0], corner[1], worldX, worldY);
+		minX = std::min(minX, worldX);
+		maxX = std::max(maxX, worldX);
+		minY = std::min(minY, worldY);
+		maxY = std::max(maxY, worldY);
+	}
+
+	s_minX = static_cast<float>(minX);
+	s_maxX = static_cast<float>(maxX);
+	s_minY = static_cast<float>(minY);
+	s_maxY = static_cast<float>(maxY);
+	s_regionGeneration = s_viewGeneration;
+}
+
+bool MapView_BeginFrame()
+{
+	bool changed = s_settingsChanged;
+	s_settingsChanged = false;
+
+	void* mapViewMap = GetMapViewMapPtr();
+	bool known = mapViewMap && !s_fitRect.IsEmpty() && CheckView(mapViewMap);
+
+	// Until the view is known again everything is shown
+	if (!known || !gMapCullEnabled)
+	{
+		if (test_and_set(s_hasRegion, false))
+			changed = true;
+		return changed;
+	}
+
+	if (!s_hasRegion || changed || s_regionGeneration != s_viewGeneration)
+	{
+		SetRegion();
+		s_hasRegion = true;
+		changed = true;
+	}
+
+	return changed;
+}
+
+bool MapView_IsVisible(const CVector3& pos)
+{
+	if (!s_hasRegion)
+		return true;
+
+	return pos.X >= s_minX && pos.X <= s_maxX
+		&& pos.Y >= s_minY && pos.Y <= s_maxY;
+}
+
+float MapView_GetScale()
+{
+	return s_scale;
+}
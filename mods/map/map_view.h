@@ -0,0 +1,53 @@
+/**
+ * @file map_view.h
+ * @brief Visible region of the map window, for culling labels and lines.
+ * @date 2026-10-17
+ *
+ * MapAttach hands every label and line we own to MapViewMap, so the game
+ * walks and clips all of them each frame. Objects outside the visible
+ * region (plus a margin) have their labels and lines unlinked from the
+ * game's lists instead, and linked back once they come into view.
+ *
+ * The pan offset and zoom fields of the ROF2 MapViewMap aren't mapped, so
+ * the view transform is measured instead. Each mouse move or wheel event
+ * over the map gives a screen point and, from
+ * MapViewMap__GetWorldCoordinates, the world point under it. Three such
+ * points that aren't in a line fix the screen-to-world transform, and a
+ * fourth that agrees with it confirms it. The visible region is then the
+ * map window's screen clip rect (CXWnd::ClipRectScreen) carried through
+ * that transform.
+ *
+ * Every frame the transform is checked against GetWorldCoordinates again,
+ * and it is dropped when the window moves or the check fails (the map was
+ * panned or zoomed). Until a transform is confirmed nothing is culled. The
+ * view is measured even with culling off, since clustering sizes its cells
+ * from the zoom.
+ *
+ * INI ([Map Culling]):
+ *   Enabled, Margin (screen pixels)
+ */
+
+#pragma once
+
+#include "map.h"
+
+extern bool gMapCullEnabled;
+
+void LoadMapViewSettings();
+
+// A mouse event over the map has been handled by the game. zoomed is set
+// for the wheel, which changes the zoom around the cursor.
+void MapView_OnMouseEvent(void* mapViewMap, const CXPoint& pos, bool zoomed);
+
+// Called once per MapUpdate. Returns true if the visible region moved or
+// its settings changed, meaning every object needs to be re-checked.
+bool MapView_BeginFrame();
+
+// True if a world position is inside the visible region. Everything is
+// visible while culling is disabled or the view isn't known.
+bool MapView_IsVisible(const CVector3& pos);
+
+// World units covered by one screen pixel at the last confirmed zoom, or 0
+// if the view hasn't been measured yet. Kept while the view is being
+// measured again, so a pan doesn't lose it.
+float MapView_GetScale();
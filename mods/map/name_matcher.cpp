@@ -0,0 +1,164 @@
+/**
+ * @file name_matcher.cpp
+ * @brief Matches a name against many patterns in one pass.
+ * @date 2026-10-17
+ */
+
+#include "pch.h"
+#include "name_matcher.h"
+
+void NameMatcher::Clear()
+{
+	m_patterns.clear();
+	m_class = {};
+	m_classCount = 1;
+	m_next.clear();
+	m_outputBegin.clear();
+	m_outputs.clear();
+}
+
+int NameMatcher::Add(std::string_view pattern, bool exact)
+{
+	for (size_t i = 0; i < m_patterns.size(); i++)
+	{
+		if (m_patterns[i].Exact == exact && m_patterns[i].Text == pattern)
+			return static_cast<int>(i);
+	}
+
+	if (pattern.empty() || m_patterns.size() >= MaxPatterns)
+		return -1;
+
+	m_patterns.push_back({ std::string(pattern), exact });
+	return static_cast<int>(m_patterns.size() - 1);
+}
+
+uint32_t NameMatcher::AddState()
+{
+	uint32_t state = static_cast<uint32_t>(m_next.size() / m_classCount);
+	m_next.resize(m_next.size() + m_classCount, NoState);
+	return state;
+}
+
+void NameMatcher::Build()
+{
+	m_class = {};
+	m_classCount = 1;
+	m_next.clear();
+	m_outputBegin.clear();
+	m_outputs.clear();
+
+	if (m_patterns.empty())
+		return;
+
+	// Columns for the bytes the patterns use, in both cases
+	for (const Pattern& pattern : m_patterns)
+	{
+		for (char c : pattern.Text)
+		{
+			uint8_t byte = static_cast<uint8_t>(c);
+			if (m_class[byte])
+				continue;
+
+			m_class[byte] = static_cast<uint8_t>(m_classCount);
+			if (byte >= 'a' && byte <= 'z')
+				m_class[byte - 'a' + 'A'] = static_cast<uint8_t>(m_classCount);
+			m_classCount++;
+		}
+	}
+
+	// Trie
+	std::vector<std::vector<uint16_t>> own;
+	AddState();
+	own.emplace_back();
+
+	for (size_t i = 0; i < m_patterns.size(); i++)
+	{
+		uint32_t state = 0;
+		for (char c : m_patterns[i].Text)
+		{
+			uint32_t& next = m_next[state * m_classCount + m_class[static_cast<uint8_t>(c)]];
+			if (next == NoState)
+			{
+				uint32_t added = AddState();
+				own.emplace_back();
+
+				// AddState can move the table
+				m_next[state * m_classCount + m_class[static_cast<uint8_t>(c)]] = added;
+				state = added;
+			}
+			else
+			{
+				state = next;
+			}
+		}
+		own[state].push_back(static_cast<uint16_t>(i));
+	}
+
+	// Breadth first, every state's failure link is already done when its
+	// children need it, so missing transitions can be filled in from it
+	// and each state inherits the outputs of its failure state.
+	size_t stateCount = own.size();
+	std::vector<uint32_t> fail(stateCount, 0);
+	std::vector<uint32_t> order;
+	order.reserve(stateCount);
+	order.push_back(0);
+
+	for (size_t head = 0; head < order.size(); head++)
+	{
+		uint32_t state = order[head];
+		for (size_t column = 0; column < m_classCount; column++)
+		{
+			uint32_t& next = m_next[state * m_classCount + column];
+			uint32_t fallback = state == 0 ? 0 : m_next[fail[state] * m_classCount + column];
+
+			if (next == NoState)
+			{
+				next = fallback;
+				continue;
+			}
+
+			fail[next] = fallback;
+			order.push_back(next);
+		}
+	}
+
+	std::vector<std::vector<uint16_t>> outputs(stateCount);
+	for (uint32_t state : order)
+	{
+		outputs[state] = own[state];
+		if (state != 0)
+			outputs[state].insert(outputs[state].end(), outputs[fail[state]].begin(), outputs[fail[state]].end());
+	}
+
+	m_outputBegin.reserve(stateCount + 1);
+	for (const auto& stateOutputs : outputs)
+	{
+		m_outputBegin.push_back(static_cast<uint32_t>(m_outputs.size()));
+		m_outputs.insert(m_outputs.end(), stateOutputs.begin(), stateOutputs.end());
+	}
+	m_outputBegin.push_back(static_cast<uint32_t>(m_outputs.size()));
+}
+
+NameMatcher::Mask NameMatcher::Scan(const char* text) const
+{
+	Mask found;
+	if (m_next.empty())
+		return found;
+
+	uint32_t state = 0;
+	for (size_t i = 0; text[i]; i++)
+	{
+		state = m_next[state * m_classCount + m_class[static_cast<uint8_t>(text[i])]];
+
+		for (uint32_t out = m_outputBegin[state]; out != m_outputBegin[state + 1]; out++)
+		{
+			const Pattern& pattern = m_patterns[m_outputs[out]];
+			if (pattern.Exact && (pattern.Text.size() != i + 1 || text[i + 1]))
+				continue;
+
+			found.set(m_outputs[out]);
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file name_matcher.h
+ * @brief Matches a name against many patterns in one pass.
+ * @date 2026-10-17
+ *
+ * Case-insensitive Aho-Corasick automaton over a set of name patterns, so a
+ * spawn name is scanned once for all of them instead of once per pattern.
+ * Only the bytes that occur in some pattern get their own column in the
+ * transition table; every other byte shares one that leads back to the
+ * root. A scan is one table lookup per character plus the patterns that
+ * end there, and reports every pattern found as a bit.
+ *
+ * An exact pattern is only reported when it is the whole text.
+ */
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class NameMatcher
+{
+public:
+	static constexpr size_t MaxPatterns = 256;
+	using Mask = std::bitset<MaxPatterns>;
+
+	void Clear();
+
+	// pattern must already be lowered and not empty. Returns its bit (an
+	// identical pattern shares one), or -1 if the matcher is full.
+	int Add(std::string_view pattern, bool exact);
+
+	// Build the automaton after the last Add
+	void Build();
+
+	bool Empty() const { return m_patterns.empty(); }
+
+	Mask Scan(const char* text) const;
+
+private:
+	static constexpr uint32_t NoState = UINT32_MAX;
+
+	struct Pattern
+	{
+		std::string Text;
+		bool        Exact;
+	};
+
+	uint32_t AddState();
+
+	std::vector<Pattern>     m_patterns;
+	std::array<uint8_t, 256> m_class = {};     // byte -> column, 0 for bytes in no pattern
+	size_t                   m_classCount = 1;
+	std::vector<uint32_t>    m_next;           // state * m_classCount + column
+	std::vector<uint32_t>    m_outputBegin;    // per state, into m_outputs (one extra at the end)
+	std::vector<uint16_t>    m_outputs;        // patterns ending at each state, suffixes included
+};
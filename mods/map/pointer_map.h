@@ -0,0 +1,192 @@
+/**
+ * @file pointer_map.h
+ * @brief Flat open-addressing hash map keyed by pointer.
+ * @date 2026-10-17
+ *
+ * Replaces the node-based std::map lookups used to go from a game pointer
+ * (spawn, ground item, label) back to its MapObject. Keys and values are
+ * stored inline in one power-of-two array and probed linearly, so a lookup
+ * is a multiply, a shift and usually a single cache line.
+ *
+ * Deletion uses backward-shift instead of tombstones: following entries
+ * that would have landed in the freed slot are pulled back, so probe
+ * sequences never grow from churn (spawns come and go constantly).
+ *
+ * nullptr is reserved as the empty-slot marker and can't be used as a key.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+template <typename K, typename V>
+class PointerMap
+{
+	static_assert(std::is_pointer_v<K>, "PointerMap keys must be pointers");
+
+public:
+	PointerMap() = default;
+
+	// Find the value for a key. Returns a value-initialized V if not present.
+	V Find(K key) const
+	{
+		if (!key || m_slots.empty())
+			return V{};
+
+		for (size_t i = HomeSlot(key); ; i = (i + 1) & m_mask)
+		{
+			const Slot& slot = m_slots[i];
+			if (slot.key == key)
+				return slot.value;
+			if (!slot.key)
+				return V{};
+		}
+	}
+
+	bool Contains(K key) const
+	{
+		if (!key || m_slots.empty())
+			return false;
+
+		for (size_t i = HomeSlot(key); ; i = (i + 1) & m_mask)
+		{
+			const Slot& slot = m_slots[i];
+			if (slot.key == key)
+				return true;
+			if (!slot.key)
+				return false;
+		}
+	}
+
+	// Insert or overwrite the value for a key.
+	void Insert(K key, V value)
+	{
+		if (!key)
+			return;
+
+		if ((m_size + 1) * 4 > m_slots.size() * 3)
+			Rehash(m_slots.empty() ? MinCapacity : m_slots.size() * 2);
+
+		for (size_t i = HomeSlot(key); ; i = (i + 1) & m_mask)
+		{
+			Slot& slot = m_slots[i];
+			if (slot.key == key)
+			{
+				slot.value = value;
+				return;
+			}
+
+			if (!slot.key)
+			{
+				slot.key = key;
+				slot.value = value;
+				++m_size;
+				return;
+			}
+		}
+	}
+
+	// Remove a key. Returns false if it wasn't present.
+	bool Erase(K key)
+	{
+		if (!key || m_slots.empty())
+			return false;
+
+		size_t hole = HomeSlot(key);
+		for (; ; hole = (hole + 1) & m_mask)
+		{
+			if (m_slots[hole].key == key)
+				break;
+			if (!m_slots[hole].key)
+				return false;
+		}
+
+		// Backward shift: walk the cluster after the hole and pull back any
+		// entry whose home slot is not cyclically within (hole, next].
+		for (size_t next = (hole + 1) & m_mask; m_slots[next].key; next = (next + 1) & m_mask)
+		{
+			size_t home = HomeSlot(m_slots[next].key);
+			bool movable = (hole <= next)
+				? (home <= hole || home > next)
+				: (home <= hole && home > next);
+
+			if (movable)
+			{
+				m_slots[hole] = m_slots[next];
+				hole = next;
+			}
+		}
+
+		m_slots[hole] = Slot{};
+		--m_size;
+		return true;
+	}
+
+	// Make room for at least count entries without further rehashing.
+	void Reserve(size_t count)
+	{
+		size_t capacity = MinCapacity;
+		while (capacity * 3 < count * 4)
+			capacity *= 2;
+
+		if (capacity > m_slots.size())
+			Rehash(capacity);
+	}
+
+	// Remove all entries but keep the table allocation.
+	void Clear()
+	{
+		for (Slot& slot : m_slots)
+			slot = Slot{};
+		m_size = 0;
+	}
+
+	size_t Size() const { return m_size; }
+	bool Empty() const { return m_size == 0; }
+
+private:
+	struct Slot
+	{
+		K key = nullptr;
+		V value{};
+	};
+
+	static constexpr size_t MinCapacity = 16;
+
+	size_t HomeSlot(K key) const
+	{
+		// Fibonacci hashing: pointers are aligned, so the low bits carry
+		// no information. The multiply spreads the high bits down.
+		uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(h >> m_shift) & m_mask;
+	}
+
+	void Rehash(size_t capacity)
+	{
+		std::vector<Slot> old;
+		old.swap(m_slots);
+
+		m_slots.resize(capacity);
+		m_mask = capacity - 1;
+
+		int bits = 0;
+		while ((size_t(1) << bits) < capacity)
+			++bits;
+		m_shift = 64 - bits;
+
+		m_size = 0;
+		for (const Slot& slot : old)
+		{
+			if (slot.key)
+				Insert(slot.key, slot.value);
+		}
+	}
+
+	std::vector<Slot> m_slots;
+	size_t            m_mask = 0;
+	int               m_shift = 64;
+	size_t            m_size = 0;
+};
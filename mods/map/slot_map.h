@@ -0,0 +1,311 @@
+/**
+ * @file slot_map.h
+ * @brief Slot map with stable addresses, generational handles and dense iteration.
+ * @date 2026-10-17
+ *
+ * Map objects, labels and lines used to be chained on hand-maintained
+ * doubly linked lists, where one missed unlink leaves a cycle behind. A
+ * SlotMap owns them instead:
+ *
+ *   - Values live in fixed-size blocks that never move, so a pointer to one
+ *     stays valid until it is erased (the game holds on to label and line
+ *     pointers while it draws).
+ *   - Every live value also has an entry in a dense pointer array, which is
+ *     what iteration walks. Erasing moves the last entry into the freed
+ *     spot, so insert, erase and iteration never touch anything else.
+ *   - A SlotHandle names a value together with the generation of its slot.
+ *     Erasing bumps the generation, so a stale handle resolves to nullptr
+ *     instead of to whatever took the slot over.
+ *
+ * A SlotMap is trivially destructible: values can still be
+ * erased during static teardown (gMapLocTemplates), after the map's own TU
+ * has been torn down. Memory only goes back to the heap through Release().
+ *
+ * Storage is the type actually constructed in a slot and T the type the map
+ * hands out, which lets the map objects of one concrete type be iterated as
+ * MapObject pointers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ---------------------------------------------------------------------------
+// DenseArray — a growable array of trivially copyable values with no
+// destructor, for the same teardown reason as SlotMap.
+// ---------------------------------------------------------------------------
+
+template <typename T>
+class DenseArray
+{
+	static_assert(std::is_trivially_copyable_v<T>, "DenseArray values are moved with memcpy");
+
+public:
+	constexpr DenseArray() = default;
+
+	T* data() const { return m_data; }
+	T* begin() const { return m_data; }
+	T* end() const { return m_data + m_size; }
+	size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	T& operator[](size_t index) const { return m_data[index]; }
+	T& back() const { return m_data[m_size - 1]; }
+
+	void push_back(const T& value)
+	{
+		if (m_size == m_capacity)
+			reserve(m_capacity ? m_capacity * 2 : 16);
+		m_data[m_size++] = value;
+	}
+
+	void pop_back() { --m_size; }
+	void clear() { m_size = 0; }
+
+	void reserve(size_t capacity)
+	{
+		if (capacity <= m_capacity)
+			return;
+
+		T* data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+		if (m_size)
+			memcpy(data, m_data, m_size * sizeof(T));
+		::operator delete(m_data);
+
+		m_data = data;
+		m_capacity = capacity;
+	}
+
+	// Return the buffer to the heap
+	void release()
+	{
+		::operator delete(m_data);
+		m_data = nullptr;
+		m_size = 0;
+		m_capacity = 0;
+	}
+
+private:
+	T*     m_data = nullptr;
+	size_t m_size = 0;
+	size_t m_capacity = 0;
+};
+
+// ---------------------------------------------------------------------------
+// SlotMap
+// ---------------------------------------------------------------------------
+
+struct SlotHandle
+{
+	static constexpr uint32_t NoIndex = UINT32_MAX;
+
+	uint32_t Index = NoIndex;
+	uint32_t Generation = 0;
+
+	explicit operator bool() const { return Index != NoIndex; }
+	bool operator==(const SlotHandle&) const = default;
+};
+
+template <typename T, typename Storage = T>
+class SlotMap
+{
+	static_assert(std::is_same_v<T, Storage> || std::is_base_of_v<T, Storage>,
+		"SlotMap storage must be the value type or derived from it");
+
+public:
+	constexpr explicit SlotMap(size_t blockSize = 256)
+		: m_blockSize(blockSize)
+	{
+	}
+
+	// Raw storage for one Storage, already counted as live. Use New() for
+	// construction; this is for class-specific operator new.
+	void* Allocate()
+	{
+		if (m_freeSlot == SlotHandle::NoIndex)
+			AddBlock(m_blockSize);
+
+		Slot* slot = GetSlot(m_freeSlot);
+		m_freeSlot = slot->link;
+
+		slot->link = static_cast<uint32_t>(m_dense.size());
+		m_dense.push_back(ValueOf(slot));
+		return slot->storage;
+	}
+
+	// Give back storage from Allocate() whose value has been destroyed
+	void Free(void* ptr)
+	{
+		if (!ptr)
+			return;
+
+		Slot* slot = static_cast<Slot*>(ptr);
+
+		T* last = m_dense.back();
+		m_dense[slot->link] = last;
+		SlotOf(last)->link = slot->link;
+		m_dense.pop_back();
+
+		++slot->generation;
+		slot->link = m_freeSlot;
+		m_freeSlot = slot->index;
+	}
+
+	template <typename... Args>
+	Storage* New(Args&&... args)
+	{
+		return ::new (Allocate()) Storage(std::forward<Args>(args)...);
+	}
+
+	void Delete(T* value)
+	{
+		if (!value)
+			return;
+
+		Storage* storage = static_cast<Storage*>(value);
+		storage->~Storage();
+		Free(storage);
+	}
+
+	SlotHandle GetHandle(const T* value) const
+	{
+		if (!value)
+			return {};
+
+		const Slot* slot = SlotOf(value);
+		return { slot->index, slot->generation };
+	}
+
+	// The value a handle names, or nullptr if it has been erased since
+	T* Get(SlotHandle handle) const
+	{
+		if (handle.Index >= m_slotCount)
+			return nullptr;
+
+		Slot* slot = GetSlot(handle.Index);
+		return slot->generation == handle.Generation ? ValueOf(slot) : nullptr;
+	}
+
+	// Live values, in no particular order
+	T* const* begin() const { return m_dense.begin(); }
+	T* const* end() const { return m_dense.end(); }
+	T* operator[](size_t index) const { return m_dense[index]; }
+	size_t size() const { return m_dense.size(); }
+	bool empty() const { return m_dense.empty(); }
+
+	// Grow (in one block) so at least count slots exist in total
+	void Reserve(size_t count)
+	{
+		if (count > m_slotCount)
+		{
+			size_t needed = count - m_slotCount;
+			size_t blocks = (needed + m_blockSize - 1) / m_blockSize;
+			AddBlock(blocks * m_blockSize);
+		}
+
+		m_dense.reserve(count);
+	}
+
+	// Return every block to the heap. Only possible when nothing is live.
+	bool Release()
+	{
+		if (!m_dense.empty())
+			return false;
+
+		// Slots made after this start past every generation handed out
+		// so far, so a handle from before can't match one of them
+		for (Block* block : m_blocks)
+		{
+			Slot* slots = block->Slots();
+			for (uint32_t i = 0; i < block->count; i++)
+			{
+				if (slots[i].generation >= m_firstGeneration)
+					m_firstGeneration = slots[i].generation + 1;
+			}
+
+			::operator delete(block);
+		}
+
+		m_blocks.release();
+		m_dense.release();
+		m_freeSlot = SlotHandle::NoIndex;
+		m_slotCount = 0;
+		return true;
+	}
+
+	size_t Capacity() const { return m_slotCount; }
+
+private:
+	struct Slot
+	{
+		alignas(Storage) unsigned char storage[sizeof(Storage)];
+		uint32_t generation;
+		uint32_t index;
+		uint32_t link;           // dense position while live, next free slot while free
+	};
+
+	struct alignas(Slot) Block
+	{
+		uint32_t first;          // index of the first slot
+		uint32_t count;
+
+		Slot* Slots() { return reinterpret_cast<Slot*>(this + 1); }
+	};
+
+	static T* ValueOf(Slot* slot)
+	{
+		return static_cast<T*>(reinterpret_cast<Storage*>(slot->storage));
+	}
+
+	static Slot* SlotOf(const T* value)
+	{
+		return reinterpret_cast<Slot*>(const_cast<Storage*>(static_cast<const Storage*>(value)));
+	}
+
+	// Blocks can differ in size (Reserve adds one big one), so find the
+	// one holding the index; there are only ever a handful.
+	Slot* GetSlot(uint32_t index) const
+	{
+		for (Block* block : m_blocks)
+		{
+			if (index - block->first < block->count)
+				return block->Slots() + (index - block->first);
+		}
+		return nullptr;
+	}
+
+	void AddBlock(size_t count)
+	{
+		void* memory = ::operator new(sizeof(Block) + count * sizeof(Slot));
+		Block* block = static_cast<Block*>(memory);
+		block->first = static_cast<uint32_t>(m_slotCount);
+		block->count = static_cast<uint32_t>(count);
+		m_blocks.push_back(block);
+
+		// Thread back-to-front so allocations walk the block in address order
+		Slot* slots = block->Slots();
+		for (size_t i = count; i-- > 0; )
+		{
+			slots[i].generation = m_firstGeneration;
+			slots[i].index = static_cast<uint32_t>(m_slotCount + i);
+			slots[i].link = m_freeSlot;
+			m_freeSlot = slots[i].index;
+		}
+
+		m_slotCount += count;
+	}
+
+	size_t             m_blockSize;
+	DenseArray<Block*> m_blocks;
+	DenseArray<T*>     m_dense;
+	uint32_t           m_freeSlot = SlotHandle::NoIndex;
+	size_t             m_slotCount = 0;
+	uint32_t           m_firstGeneration = 0;
+};
+
+static_assert(std::is_trivially_destructible_v<SlotMap<int>>, "SlotMap must survive static teardown");
@@ -45,6 +45,7 @@
 #include <algorithm>
 #include <charconv>
 #include <unordered_map>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 // External definitions needed for function pointer resolution
@@ -223,6 +224,32 @@ const char* GetClassThreeLetterCode(SPAWNINFO* p)
 
 } // namespace SpawnAccess
 
+// ---------------------------------------------------------------------------
+// ZoneAccess namespace
+// ---------------------------------------------------------------------------
+
+namespace ZoneOffsets
+{
+    constexpr uintptr_t ShortName    = 0x040;
+    constexpr size_t    ShortNameSize = 0x80;
+}
+
+namespace ZoneAccess
+{
+
+const char* GetShortName()
+{
+    eqlib::ZONEINFO* pZone = pZoneInfo;
+    if (!pZone)
+        return "";
+
+    // The buffer is fixed size; anything unterminated isn't a zone name
+    const char* name = PtrAt<const char>(pZone, ZoneOffsets::ShortName);
+    return strnlen(name, ZoneOffsets::ShortNameSize) < ZoneOffsets::ShortNameSize ? name : "";
+}
+
+} // namespace ZoneAccess
+
 // ---------------------------------------------------------------------------
 // Function pointers for game functions (resolved once)
 // ---------------------------------------------------------------------------
@@ -269,6 +296,19 @@ static void ResolveFuncPtrs()
 //   +0x04: HashNode<int>* pNext
 //   +0x08: int key (hash key)
 
+struct PropertyHashNode
+{
+    int               Value;
+    PropertyHashNode* pNext;
+    int               Key;
+};
+
+static auto WalkHashChain(PropertyHashNode* pFirst)
+{
+    return GameList::Walk(pFirst, [](PropertyHashNode* pNode) { return pNode->pNext; },
+        sizeof(PropertyHashNode), GameList::MaxHashChain);
+}
+
 // SEH-protected body type lookup — the Properties hash table offset (0x128) is
 // unverified for this build and may crash if incorrect.
 static int GetBodyType_Inner(SPAWNINFO* pSpawn)
@@ -276,24 +316,23 @@ static int GetBodyType_Inner(SPAWNINFO* pSpawn)
     uintptr_t propsAddr = reinterpret_cast<uintptr_t>(pSpawn) + SpawnOffsets::Properties;
 
     // HashTable<int>: first member is pointer to bucket array, second is table size
-    void** pHashData = *reinterpret_cast<void***>(propsAddr);
+    PropertyHashNode** pHashData = *reinterpret_cast<PropertyHashNode***>(propsAddr);
     int tableSize = *reinterpret_cast<int*>(propsAddr + 0x04);
 
-    if (!pHashData || tableSize <= 0 || tableSize > 256)
+    if (!pHashData || tableSize <= 0 || tableSize > 256
+        || !GameList::IsReadable(pHashData, tableSize * sizeof(PropertyHashNode*)))
+    {
         return 0;
+    }
 
     int minProperty = 0;
 
     for (int i = 0; i < tableSize; i++)
     {
-        uintptr_t node = reinterpret_cast<uintptr_t>(pHashData[i]);
-        while (node)
+        for (PropertyHashNode* pNode : WalkHashChain(pHashData[i]))
         {
-            int value = *reinterpret_cast<int*>(node);
-            if (minProperty == 0 || value < minProperty)
-                minProperty = value;
-            // pNext is at offset +0x04 in HashNode
-            node = reinterpret_cast<uintptr_t>(*reinterpret_cast<void**>(node + 0x04));
+            if (minProperty == 0 || pNode->Value < minProperty)
+                minProperty = pNode->Value;
         }
     }
 
@@ -302,14 +341,11 @@ static int GetBodyType_Inner(SPAWNINFO* pSpawn)
     {
         for (int i = 0; i < tableSize; i++)
         {
-            uintptr_t node = reinterpret_cast<uintptr_t>(pHashData[i]);
-            while (node)
+            for (PropertyHashNode* pNode : WalkHashChain(pHashData[i]))
             {
-                int value = *reinterpret_cast<int*>(node);
-                if (value == MQ_CharProp_Trap) return MQ_CharProp_Trap;
-                if (value == MQ_CharProp_Companion) return MQ_CharProp_Companion;
-                if (value == MQ_CharProp_Suicide) return MQ_CharProp_Suicide;
-                node = reinterpret_cast<uintptr_t>(*reinterpret_cast<void**>(node + 0x04));
+                if (pNode->Value == MQ_CharProp_Trap) return MQ_CharProp_Trap;
+                if (pNode->Value == MQ_CharProp_Companion) return MQ_CharProp_Companion;
+                if (pNode->Value == MQ_CharProp_Suicide) return MQ_CharProp_Suicide;
             }
         }
     }
@@ -318,7 +354,7 @@ static int GetBodyType_Inner(SPAWNINFO* pSpawn)
 }
 
 // SEH-protected call — must be in a separate function from C++ objects
-// that require unwinding (std::unordered_map).
+// that require unwinding.
 static int GetBodyType_SEH(SPAWNINFO* pSpawn)
 {
     __try
@@ -338,27 +374,6 @@ static int GetBodyType_SEH(SPAWNINFO* pSpawn)
     }
 }
 
-static std::unordered_map<SPAWNINFO*, int> s_bodyTypeCache;
-
-void ClearBodyTypeCache()
-{
-    s_bodyTypeCache.clear();
-}
-
-int GetBodyType(SPAWNINFO* pSpawn)
-{
-    if (!pSpawn)
-        return 0;
-
-    auto it = s_bodyTypeCache.find(pSpawn);
-    if (it != s_bodyTypeCache.end())
-        return it->second;
-
-    int result = GetBodyType_SEH(pSpawn);
-    s_bodyTypeCache[pSpawn] = result;
-    return result;
-}
-
 // ---------------------------------------------------------------------------
 // String utilities
 // ---------------------------------------------------------------------------
@@ -525,11 +540,8 @@ int ci_find_substr(std::string_view haystack, std::string_view needle)
 // Spawn utilities
 // ---------------------------------------------------------------------------
 
-eSpawnType GetSpawnType(SPAWNINFO* pSpawn)
+static eSpawnType ClassifySpawnType(SPAWNINFO* pSpawn, int bodyType)
 {
-    if (!pSpawn)
-        return NONE;
-
     uint8_t type = SpawnAccess::GetType(pSpawn);
 
     switch (type)
@@ -561,7 +573,6 @@ eSpawnType GetSpawnType(SPAWNINFO* pSpawn)
         if (std::isnan(y) && std::isnan(x) && std::isnan(z))
             return FLYER;
 
-        int bodyType = GetBodyType(pSpawn);
         int spawnClass = SpawnAccess::GetClass(pSpawn);
         int spawnRace = SpawnAccess::GetRace(pSpawn);
         const char* name = SpawnAccess::GetName(pSpawn);
@@ -676,12 +687,9 @@ uint32_t ConColorToARGB(int conColor)
     }
 }
 
-bool IsNamed(SPAWNINFO* pSpawn)
+static bool ClassifyNamed(SPAWNINFO* pSpawn, eSpawnType type)
 {
-    if (!pSpawn)
-        return false;
-
-    if (GetSpawnType(pSpawn) != NPC)
+    if (type != NPC)
         return false;
 
     if (SpawnAccess::GetClass(pSpawn) == MQ_Class_Object)
@@ -708,6 +716,122 @@ bool IsNamed(SPAWNINFO* pSpawn)
     return false;
 }
 
+// ---------------------------------------------------------------------------
+// Spawn classification cache
+// ---------------------------------------------------------------------------
+
+static std::vector<SpawnClass> s_spawnClasses;
+static std::unordered_map<uint32_t, uint32_t> s_spawnClassIndex;  // spawn ID -> index
+
+SpawnClassInputs GetSpawnClassInputs(SPAWNINFO* pSpawn)
+{
+    SpawnClassInputs inputs;
+    inputs.Type = SpawnAccess::GetType(pSpawn);
+    inputs.MasterID = SpawnAccess::GetMasterID(pSpawn);
+    inputs.Rider = SpawnAccess::GetRider(pSpawn);
+    inputs.Mercenary = SpawnAccess::GetMercenary(pSpawn);
+    inputs.Race = SpawnAccess::GetRace(pSpawn);
+    inputs.Class = SpawnAccess::GetClass(pSpawn);
+    return inputs;
+}
+
+static void ClassifySpawn(SpawnClass& entry, SPAWNINFO* pSpawn)
+{
+    entry.Spawn = pSpawn;
+    entry.SpawnID = SpawnAccess::GetSpawnID(pSpawn);
+    entry.BodyType = GetBodyType_SEH(pSpawn);
+    entry.Type = ClassifySpawnType(pSpawn, entry.BodyType);
+    entry.Named = ClassifyNamed(pSpawn, entry.Type);
+}
+
+static void RemoveSpawnClass(std::unordered_map<uint32_t, uint32_t>::iterator it)
+{
+    uint32_t index = it->second;
+    s_spawnClassIndex.erase(it);
+
+    uint32_t last = static_cast<uint32_t>(s_spawnClasses.size() - 1);
+    if (index != last)
+    {
+        s_spawnClasses[index] = s_spawnClasses[last];
+        s_spawnClassIndex[s_spawnClasses[index].SpawnID] = index;
+    }
+    s_spawnClasses.pop_back();
+}
+
+const SpawnClass* GetSpawnClass(SPAWNINFO* pSpawn)
+{
+    if (!pSpawn)
+        return nullptr;
+
+    uint32_t spawnID = SpawnAccess::GetSpawnID(pSpawn);
+    auto [it, inserted] = s_spawnClassIndex.try_emplace(spawnID, static_cast<uint32_t>(s_spawnClasses.size()));
+
+    if (inserted)
+    {
+        SpawnClass& entry = s_spawnClasses.emplace_back();
+        ClassifySpawn(entry, pSpawn);
+        return &entry;
+    }
+
+    // The ID went to a different spawn without us seeing it destroyed
+    SpawnClass& entry = s_spawnClasses[it->second];
+    if (entry.Spawn != pSpawn)
+        ClassifySpawn(entry, pSpawn);
+
+    return &entry;
+}
+
+void SpawnClass_Invalidate(SPAWNINFO* pSpawn)
+{
+    if (!pSpawn)
+        return;
+
+    auto it = s_spawnClassIndex.find(SpawnAccess::GetSpawnID(pSpawn));
+    if (it != s_spawnClassIndex.end())
+        RemoveSpawnClass(it);
+}
+
+void SpawnClass_OnCreate(SPAWNINFO* pSpawn)
+{
+    // Whatever is left under the ID belonged to an earlier spawn
+    SpawnClass_Invalidate(pSpawn);
+}
+
+void SpawnClass_OnDestroy(SPAWNINFO* pSpawn)
+{
+    if (!pSpawn)
+        return;
+
+    // Leave the entry alone if the ID already belongs to a newer spawn
+    auto it = s_spawnClassIndex.find(SpawnAccess::GetSpawnID(pSpawn));
+    if (it != s_spawnClassIndex.end() && s_spawnClasses[it->second].Spawn == pSpawn)
+        RemoveSpawnClass(it);
+}
+
+void ClearSpawnClassCache()
+{
+    s_spawnClasses.clear();
+    s_spawnClassIndex.clear();
+}
+
+eSpawnType GetSpawnType(SPAWNINFO* pSpawn)
+{
+    const SpawnClass* spawnClass = GetSpawnClass(pSpawn);
+    return spawnClass ? spawnClass->Type : NONE;
+}
+
+int GetBodyType(SPAWNINFO* pSpawn)
+{
+    const SpawnClass* spawnClass = GetSpawnClass(pSpawn);
+    return spawnClass ? spawnClass->BodyType : 0;
+}
+
+bool IsNamed(SPAWNINFO* pSpawn)
+{
+    const SpawnClass* spawnClass = GetSpawnClass(pSpawn);
+    return spawnClass && spawnClass->Named;
+}
+
 SPAWNINFO* GetSpawnByID(uint32_t spawnID)
 {
     ResolveFuncPtrs();
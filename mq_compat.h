@@ -14,6 +14,7 @@
 #include "commands.h"
 #include "config.h"
 #include "core.h"
+#include "game_list.h"
 
 #include <cstdint>
 #include <cstdio>
@@ -530,6 +531,22 @@ namespace SpawnAccess
     const char* GetRaceString(SPAWNINFO* pSpawn);
     const char* GetClassString(SPAWNINFO* pSpawn);
     const char* GetClassThreeLetterCode(SPAWNINFO* pSpawn);
+
+    // Bytes of a spawn the accessors above reach into (up to Class at
+    // +0x0eb8). List walks check this much is readable.
+    constexpr size_t NodeSize = 0x0ebc;
+}
+
+// ZONEINFO (EQZoneInfo) layout:
+//   +0x000 CharacterName[0x40]
+//   +0x040 ShortName[0x80]
+//   +0x0c0 LongName[0x80]
+
+namespace ZoneAccess
+{
+    // Short name of the current zone ("gfaydark"), or "" if there is no
+    // zone info yet
+    const char* GetShortName();
 }
 
 // ---------------------------------------------------------------------------
@@ -538,7 +555,6 @@ namespace SpawnAccess
 
 eSpawnType GetSpawnType(SPAWNINFO* pSpawn);
 int GetBodyType(SPAWNINFO* pSpawn);
-void ClearBodyTypeCache();
 int ConColor(SPAWNINFO* pSpawn);
 uint32_t ConColorToARGB(int conColor);
 bool IsNamed(SPAWNINFO* pSpawn);
@@ -546,6 +562,66 @@ SPAWNINFO* GetSpawnByID(uint32_t spawnID);
 float DistanceToSpawn(SPAWNINFO* pFrom, SPAWNINFO* pTo);
 float get_melee_range(SPAWNINFO* pSpawn1, SPAWNINFO* pSpawn2);
 
+// Bounded, cycle-safe walks over the spawn and ground item lists
+inline auto WalkSpawns(SPAWNINFO* pFirst)
+{
+    return GameList::Walk(pFirst, &SpawnAccess::GetNext, SpawnAccess::NodeSize, GameList::MaxSpawns);
+}
+
+inline auto WalkGroundItems(GROUNDITEM* pFirst)
+{
+    return GameList::Walk(pFirst, [](GROUNDITEM* pItem) { return pItem->pNext; },
+        sizeof(GROUNDITEM), GameList::MaxGroundItems);
+}
+
+// ---------------------------------------------------------------------------
+// Spawn classification cache
+//
+// GetSpawnType, GetBodyType and IsNamed read from a cache entry per spawn,
+// keyed by spawn ID. An entry also records the spawn it was built for, so a
+// recycled ID or reused spawn memory is classified afresh.
+//
+// Lookups don't re-read the spawn. Whoever already watches a spawn calls
+// SpawnClass_Invalidate when a field the class is worked out from changes:
+// the SpawnClassInputs below, either name, or the position of a FLYER (an
+// NPC with no position yet). E.g. an NPC that dies becomes a corpse.
+// ---------------------------------------------------------------------------
+
+struct SpawnClass
+{
+    SPAWNINFO*  Spawn = nullptr;
+    uint32_t    SpawnID = 0;
+
+    eSpawnType  Type = NONE;
+    int         BodyType = 0;
+    bool        Named = false;
+};
+
+// The raw fields, other than names and position, a class is worked out from
+struct SpawnClassInputs
+{
+    uint8_t     Type = 0;
+    uint32_t    MasterID = 0;
+    SPAWNINFO*  Rider = nullptr;
+    bool        Mercenary = false;
+    int         Race = 0;
+    int         Class = 0;
+
+    bool operator==(const SpawnClassInputs&) const = default;
+};
+
+SpawnClassInputs GetSpawnClassInputs(SPAWNINFO* pSpawn);
+
+const SpawnClass* GetSpawnClass(SPAWNINFO* pSpawn);
+
+// Drop a spawn's entry; the next lookup classifies it again
+void SpawnClass_Invalidate(SPAWNINFO* pSpawn);
+
+// Spawn lifetime events. OnCreate drops any entry left under the spawn's ID.
+void SpawnClass_OnCreate(SPAWNINFO* pSpawn);
+void SpawnClass_OnDestroy(SPAWNINFO* pSpawn);
+void ClearSpawnClassCache();
+
 const char* GetFriendlyNameForGroundItem(EQGroundItem* pItem);
 int MakeTime();
 